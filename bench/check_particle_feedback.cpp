@@ -0,0 +1,181 @@
+// Checks the transform feedback particle path (BREAKOUT_GPU_PARTICLES=1)
+// against the CPU ParticlePool: the same particles are spawned into both
+// over a few hundred frames and every live particle read back from the GPU
+// buffer has to match its CPU twin. A single oversized burst then checks
+// that the ring keeps the newest particles. Needs an OpenGL 3.3 driver
+// reachable through EGL without a window (Mesa's surfaceless platform, e.g.
+// llvmpipe); run it from the repository root. Returns the number of failed
+// checks.
+//
+// compile:
+// clang++ -std=c++17 -O2 ./bench/check_particle_feedback.cpp ./src/ParticleFeedback.cpp ./src/ParticlePool.cpp ./src/shader.cpp ./src/GLState.cpp -x c ./src/glad.c -x none -I ./include/ -I ./thirdparty/old/glm -lEGL -ldl -o check_particle_feedback
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ParticleFeedback.h"
+#include "ParticlePool.h"
+#include "shader.h"
+
+static unsigned int const Capacity = 256;
+static float const DeltaTime = 1.0f / 60.0f;
+static float const FadeRate = 2.5f;
+
+static bool create_context()
+{
+	PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if (getPlatformDisplay == nullptr)
+		return false;
+	EGLDisplay Display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+	EGLint Major, Minor;
+	if (Display == EGL_NO_DISPLAY || !eglInitialize(Display, &Major, &Minor) || !eglBindAPI(EGL_OPENGL_API))
+		return false;
+	EGLint const ConfigAttributes[] = { EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+	EGLConfig Config;
+	EGLint Configs = 0;
+	if (!eglChooseConfig(Display, ConfigAttributes, &Config, 1, &Configs) || Configs == 0)
+		return false;
+	EGLint const ContextAttributes[] = {
+		EGL_CONTEXT_MAJOR_VERSION, 3, EGL_CONTEXT_MINOR_VERSION, 3,
+		EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT, EGL_NONE };
+	EGLContext Context = eglCreateContext(Display, Config, EGL_NO_CONTEXT, ContextAttributes);
+	EGLint const SurfaceAttributes[] = { EGL_WIDTH, 16, EGL_HEIGHT, 16, EGL_NONE };
+	EGLSurface Surface = eglCreatePbufferSurface(Display, Config, SurfaceAttributes);
+	if (Context == EGL_NO_CONTEXT || !eglMakeCurrent(Display, Surface, Surface, Context))
+		return false;
+	return gladLoadGLLoader((GLADloadproc)eglGetProcAddress) != 0;
+}
+
+static Shader load_update_shader()
+{
+	std::ifstream File("shaders/particle_update.vs");
+	std::stringstream Source;
+	Source << File.rdbuf();
+	Shader Update;
+	Update.CompileFeedback(Source.str().c_str(), { "outPosition", "outVelocity", "outColor", "outLife" });
+	return Update;
+}
+
+// the used slots of the buffer the particles are drawn from, found through the public render binding
+static std::vector<GPUParticle> read_back(ParticleFeedback &Feedback)
+{
+	std::vector<GPUParticle> Particles(Feedback.Bind());
+	GLint Buffer = 0;
+	glGetVertexAttribiv(1, GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING, &Buffer);
+	glBindBuffer(GL_ARRAY_BUFFER, Buffer);
+	glGetBufferSubData(GL_ARRAY_BUFFER, 0, Particles.size() * sizeof(GPUParticle), Particles.data());
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	return Particles;
+}
+
+static bool near(float a, float b)
+{
+	return std::abs(a - b) < 1e-3f * (1.0f + std::abs(b));
+}
+
+// every particle has a distinct horizontal velocity, which identifies it on both sides
+static int comp_pool(ParticleFeedback &Feedback, ParticlePool &Pool, int Frame)
+{
+	std::map<float, GPUParticle> Live;
+	for (GPUParticle const &Particle : read_back(Feedback))
+		if (Particle.Life > 0.0f)
+			Live[Particle.Velocity.x] = Particle;
+
+	int Error = Live.size() == Pool.Live && Feedback.Live() == Pool.Live ? 0 : 1;
+	for (unsigned int i = 0; i < Pool.Live && Error == 0; ++i)
+	{
+		std::map<float, GPUParticle>::const_iterator It = Live.find(Pool.VX[i]);
+		if (It == Live.end())
+			++Error;
+		else
+		{
+			GPUParticle const &Particle = It->second;
+			Error += near(Particle.Position.x, Pool.X[i]) && near(Particle.Position.y, Pool.Y[i]) && near(Particle.Velocity.y, Pool.VY[i])
+				&& near(Particle.Color.a, Pool.A[i]) && near(Particle.Life, Pool.Life[i]) ? 0 : 1;
+		}
+	}
+	if (Error)
+		std::printf("FAIL frame %d: %zu live on the GPU (%u counted), %u on the CPU\n", Frame, Live.size(), Feedback.Live(), Pool.Live);
+	return Error;
+}
+
+static int check_against_pool(Shader const &Update, unsigned int QuadVBO)
+{
+	ParticleFeedback Feedback(Update, Capacity, QuadVBO, FadeRate);
+	ParticlePool Pool(Capacity, FadeRate, OVERFLOW_DROP);
+
+	// a few particles a frame living up to a second stay below the capacity, so neither side has to drop or replace any
+	int Error = 0, Id = 0;
+	for (int Frame = 0; Frame < 300 && Error == 0; ++Frame)
+	{
+		for (int i = 0; i < 3; ++i, ++Id)
+		{
+			glm::vec2 Position(Id % 800, Frame), Velocity(Id + 1, -20.0f - i);
+			glm::vec4 Color(0.5f, 0.6f, 0.7f, 1.0f);
+			// lives fall between frames, so float drift can't decide on which frame a particle dies
+			float Life = ((Id * 7) % 50 + 0.5f) * DeltaTime;
+			Feedback.Spawn(Position, Velocity, Color, Life);
+			Pool.Spawn(Position, Velocity, Color, Life);
+		}
+		Feedback.Update(DeltaTime);
+		Pool.Update(DeltaTime);
+		Error += comp_pool(Feedback, Pool, Frame);
+	}
+	std::printf("%d frames against ParticlePool, %u slots used\n", 300, Feedback.Used());
+	return Error;
+}
+
+static int check_overflow(Shader const &Update, unsigned int QuadVBO)
+{
+	ParticleFeedback Feedback(Update, Capacity, QuadVBO, FadeRate);
+	// twice the capacity in one burst: the ring keeps the newest half
+	for (unsigned int i = 0; i < 2 * Capacity; ++i)
+		Feedback.Spawn(glm::vec2(0.0f), glm::vec2(i, 0.0f), glm::vec4(1.0f), 1.0f);
+	Feedback.Update(DeltaTime);
+
+	int Error = Feedback.Used() == Capacity && Feedback.Live() == Capacity ? 0 : 1;
+	std::vector<GPUParticle> Particles = read_back(Feedback);
+	std::vector<bool> Seen(Capacity, false);
+	for (GPUParticle const &Particle : Particles)
+	{
+		int Newest = static_cast<int>(Particle.Velocity.x) - static_cast<int>(Capacity);
+		if (Newest < 0 || Seen[Newest] || Particle.Life <= 0.0f)
+			++Error;
+		else
+			Seen[Newest] = true;
+	}
+	if (Error)
+		std::printf("FAIL overflow: %u used, %u live\n", Feedback.Used(), Feedback.Live());
+	return Error;
+}
+
+int main()
+{
+	if (!create_context())
+	{
+		std::printf("FAIL no OpenGL 3.3 context through EGL\n");
+		return 1;
+	}
+	std::printf("%s\n", glGetString(GL_RENDERER));
+
+	Shader Update = load_update_shader();
+	unsigned int QuadVBO;
+	glGenBuffers(1, &QuadVBO);
+
+	int Error = 0;
+
+	Error += check_against_pool(Update, QuadVBO);
+	Error += check_overflow(Update, QuadVBO);
+	Error += glGetError() == GL_NO_ERROR ? 0 : 1;
+
+	std::printf(Error ? "%d checks failed\n" : "all checks passed\n", Error);
+	return Error;
+}
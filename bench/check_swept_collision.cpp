@@ -0,0 +1,142 @@
+// Checks SweepCircleBox on the cases its branches exist for: a circle already
+// touching the box, a center inside the box, paths through a corner region
+// that hit or miss the corner, and motion along a single axis. Random sweeps
+// are then compared with a densely sampled reference. Returns the number of
+// failed checks.
+//
+// compile:
+// clang++ -std=c++17 -O2 ./bench/check_swept_collision.cpp -I ./include/ -I ./thirdparty/old/glm -o check_swept_collision
+#include <glm/glm.hpp>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+#include "SweptCollision.h"
+
+static glm::vec2 const BoxMin(0.0f), BoxMax(10.0f);
+
+static bool near(float a, float b)
+{
+	return std::abs(a - b) < 1e-4f;
+}
+
+static bool near(glm::vec2 a, glm::vec2 b)
+{
+	return near(a.x, b.x) && near(a.y, b.y);
+}
+
+static int expect_hit(char const *Name, glm::vec2 Center, float Radius, glm::vec2 Motion, float Time, glm::vec2 Normal)
+{
+	SweepHit Hit;
+	bool Got = SweepCircleBox(Center, Radius, Motion, BoxMin, BoxMax, Hit);
+	if (Got && near(Hit.Time, Time) && near(Hit.Normal, Normal))
+		return 0;
+	if (Got)
+		std::printf("FAIL %s: hit at %f normal (%f, %f), expected %f (%f, %f)\n", Name, Hit.Time, Hit.Normal.x, Hit.Normal.y, Time, Normal.x, Normal.y);
+	else
+		std::printf("FAIL %s: no hit, expected one at %f\n", Name, Time);
+	return 1;
+}
+
+static int expect_miss(char const *Name, glm::vec2 Center, float Radius, glm::vec2 Motion)
+{
+	SweepHit Hit;
+	if (!SweepCircleBox(Center, Radius, Motion, BoxMin, BoxMax, Hit))
+		return 0;
+	std::printf("FAIL %s: hit at %f, expected none\n", Name, Hit.Time);
+	return 1;
+}
+
+static int check_cases()
+{
+	int Error = 0;
+
+	// touching at start: a hit right away while moving in, none while moving out or along the face
+	Error += expect_hit("touching, moving in", glm::vec2(-2.0f, 5.0f), 2.0f, glm::vec2(5.0f, 1.0f), 0.0f, glm::vec2(-1.0f, 0.0f));
+	Error += expect_miss("touching, moving out", glm::vec2(-2.0f, 5.0f), 2.0f, glm::vec2(-5.0f, 1.0f));
+	Error += expect_miss("touching, sliding along", glm::vec2(-2.0f, 5.0f), 2.0f, glm::vec2(0.0f, 3.0f));
+	Error += expect_hit("touching a corner", glm::vec2(-1.0f, -1.0f), 2.0f, glm::vec2(1.0f, 3.0f), 0.0f, glm::normalize(glm::vec2(-1.0f)));
+
+	// center inside the box: out through the nearest face, a hit only while moving away from it
+	Error += expect_hit("inside, moving deeper", glm::vec2(9.0f, 4.0f), 1.0f, glm::vec2(-3.0f, 0.0f), 0.0f, glm::vec2(1.0f, 0.0f));
+	Error += expect_miss("inside, moving out", glm::vec2(9.0f, 4.0f), 1.0f, glm::vec2(3.0f, 0.0f));
+
+	// through a corner region: the grown box is entered but the corner's circle is missed, or hit
+	Error += expect_miss("corner region miss", glm::vec2(-10.0f, 2.0f), 5.0f, glm::vec2(10.0f, -10.0f));
+	float Diagonal = std::sqrt(0.5f) * 5.0f;
+	Error += expect_hit("corner region hit", glm::vec2(-10.0f), 5.0f, glm::vec2(20.0f), (10.0f - Diagonal) / 20.0f, glm::normalize(glm::vec2(-1.0f)));
+
+	// zero motion along an axis: that axis only decides whether the path is in the slab
+	Error += expect_hit("x only, face", glm::vec2(-10.0f, 5.0f), 2.0f, glm::vec2(20.0f, 0.0f), 0.4f, glm::vec2(-1.0f, 0.0f));
+	Error += expect_miss("x only, beside", glm::vec2(-10.0f, 13.0f), 2.0f, glm::vec2(20.0f, 0.0f));
+	Error += expect_hit("x only, corner", glm::vec2(-10.0f, 11.0f), 2.0f, glm::vec2(20.0f, 0.0f), (10.0f - std::sqrt(3.0f)) / 20.0f, glm::vec2(-std::sqrt(3.0f), 1.0f) / 2.0f);
+	Error += expect_hit("y only, face", glm::vec2(5.0f, 20.0f), 2.0f, glm::vec2(0.0f, -20.0f), 0.4f, glm::vec2(0.0f, 1.0f));
+	Error += expect_miss("y only, too short", glm::vec2(5.0f, 20.0f), 2.0f, glm::vec2(0.0f, -7.0f));
+	Error += expect_miss("no motion", glm::vec2(-10.0f, 5.0f), 2.0f, glm::vec2(0.0f));
+
+	return Error;
+}
+
+// random sweeps that don't start touching, against the first of many sampled positions that does
+static int check_random(int Sweeps)
+{
+	int const Steps = 20000;
+	float const Tolerance = 2.0f / Steps + 1e-4f;
+	std::mt19937 Random(1);
+	std::uniform_real_distribution<float> Unit(0.0f, 1.0f);
+	auto uniform = [&](float a, float b) { return a + (b - a) * Unit(Random); };
+
+	int Error = 0, Hits = 0;
+	for (int k = 0; k < Sweeps; ++k)
+	{
+		glm::vec2 Min(uniform(-50.0f, 50.0f), uniform(-50.0f, 50.0f)), Max = Min + glm::vec2(uniform(1.0f, 60.0f), uniform(1.0f, 30.0f));
+		glm::vec2 Center(uniform(-150.0f, 150.0f), uniform(-150.0f, 150.0f)), Motion(uniform(-400.0f, 400.0f), uniform(-400.0f, 400.0f));
+		float Radius = uniform(2.0f, 15.0f);
+		glm::vec2 Offset = Center - glm::clamp(Center, Min, Max);
+		if (glm::dot(Offset, Offset) <= Radius * Radius)
+			continue;
+
+		float Reference = -1.0f;
+		for (int i = 0; i <= Steps && Reference < 0.0f; ++i)
+		{
+			glm::vec2 Point = Center + Motion * (i / static_cast<float>(Steps));
+			glm::vec2 Distance = Point - glm::clamp(Point, Min, Max);
+			if (glm::dot(Distance, Distance) <= Radius * Radius)
+				Reference = i / static_cast<float>(Steps);
+		}
+
+		SweepHit Hit;
+		bool Got = SweepCircleBox(Center, Radius, Motion, Min, Max, Hit);
+		Hits += Got ? 1 : 0;
+		bool Agree;
+		if (Got != (Reference >= 0.0f))
+			// a graze at the very end of the motion may fall between the samples
+			Agree = (Got ? Hit.Time : Reference) > 1.0f - Tolerance;
+		else
+			Agree = !Got || std::abs(Hit.Time - Reference) <= Tolerance;
+		if (Got)
+		{
+			// the contact is on the circle's rim and the normal opposes the motion
+			glm::vec2 Point = Center + Motion * Hit.Time;
+			Agree = Agree && std::abs(glm::length(Point - glm::clamp(Point, Min, Max)) - Radius) < 1e-2f && glm::dot(Hit.Normal, Motion) < 0.0f;
+		}
+		if (!Agree)
+		{
+			std::printf("FAIL random sweep %d: %s at %f, reference %f\n", k, Got ? "hit" : "no hit", Got ? Hit.Time : 0.0f, Reference);
+			++Error;
+		}
+	}
+	std::printf("%d random sweeps, %d hits, %d mismatches\n", Sweeps, Hits, Error);
+	return Error;
+}
+
+int main()
+{
+	int Error = 0;
+
+	Error += check_cases();
+	Error += check_random(100000);
+
+	std::printf(Error ? "%d checks failed\n" : "all checks passed\n", Error);
+	return Error;
+}
@@ -0,0 +1,119 @@
+// Compares the array-of-structs particle update ParticleGenerator used to run
+// (every slot visited each frame, dead or alive) with the structure-of-arrays
+// ParticlePool, using its scalar and its SIMD kernel, for pool sizes from 500
+// to 1,000,000. Half of the particles start dead, the rest die over time.
+//
+// compile:
+// clang++ -std=c++17 -O2 -mavx2 ./bench/perf_particle_update.cpp ./src/ParticlePool.cpp -I ./include/ -I ./thirdparty/old/glm -o perf_particle_update
+#include <glm/glm.hpp>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+
+#include "ParticlePool.h"
+
+struct Particle
+{
+	glm::vec2 Position, Velocity;
+	glm::vec4 Color;
+	float Life;
+};
+
+static int const Frames = 30;
+static float const DeltaTime = 1.0f / 60.0f;
+
+static float initial_life(std::size_t i)
+{
+	// every other particle is dead, the others expire spread over the frames
+	return i % 2 ? 0.0f : static_cast<float>(i % Frames) * DeltaTime + 0.001f;
+}
+
+static void test_aos(std::vector<Particle>& P)
+{
+	for (int f = 0; f < Frames; ++f)
+	for (std::size_t i = 0, n = P.size(); i < n; ++i)
+	{
+		Particle &p = P[i];
+		p.Life -= DeltaTime;
+		if (p.Life > 0.0f)
+		{
+			p.Position -= p.Velocity * DeltaTime;
+			p.Color.a -= DeltaTime * 2.5f;
+		}
+	}
+}
+
+static void test_soa_scalar(ParticlePool& P)
+{
+	for (int f = 0; f < Frames; ++f)
+		P.UpdateScalar(DeltaTime);
+}
+
+static void test_soa_simd(ParticlePool& P)
+{
+	for (int f = 0; f < Frames; ++f)
+		P.Update(DeltaTime);
+}
+
+template <typename T>
+static int launch(void (*Test)(T&), T& P)
+{
+	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+	Test(P);
+	std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+
+	return static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count());
+}
+
+static void fill(ParticlePool& P, std::size_t Samples)
+{
+	for (std::size_t i = 0; i < Samples; ++i)
+		P.Spawn(glm::vec2(static_cast<float>(i % 800), static_cast<float>(i % 600)), glm::vec2(1.0f, -2.0f), glm::vec4(1.0f), initial_life(i));
+}
+
+static int comp_particle_update(std::size_t Samples)
+{
+	int Error = 0;
+
+	std::vector<Particle> AoS(Samples);
+	for (std::size_t i = 0; i < Samples; ++i)
+	{
+		AoS[i].Position = glm::vec2(static_cast<float>(i % 800), static_cast<float>(i % 600));
+		AoS[i].Velocity = glm::vec2(1.0f, -2.0f);
+		AoS[i].Color = glm::vec4(1.0f);
+		AoS[i].Life = initial_life(i);
+	}
+	ParticlePool Scalar(static_cast<unsigned int>(Samples)), Simd(static_cast<unsigned int>(Samples));
+	fill(Scalar, Samples);
+	fill(Simd, Samples);
+
+	std::printf("%7zu particles:", Samples);
+	std::printf(" AoS %6d us,", launch(test_aos, AoS));
+	std::printf(" SoA scalar %6d us,", launch(test_soa_scalar, Scalar));
+	std::printf(" SoA SIMD %6d us\n", launch(test_soa_simd, Simd));
+
+	// the survivors must match the reference, in spawn order
+	std::size_t Live = 0;
+	for (std::size_t i = 0; i < Samples; ++i)
+	{
+		if (AoS[i].Life <= 0.0f)
+			continue;
+		Error += Live < Simd.Live && glm::abs(AoS[i].Position.x - Simd.X[Live]) < 0.01f && glm::abs(AoS[i].Color.a - Simd.A[Live]) < 0.01f ? 0 : 1;
+		++Live;
+	}
+	Error += Live == Simd.Live && Live == Scalar.Live ? 0 : 1;
+
+	return Error;
+}
+
+int main()
+{
+	std::size_t const Sizes[] = { 500, 5000, 50000, 500000, 1000000 };
+
+	int Error = 0;
+
+	for (std::size_t Samples : Sizes)
+		Error += comp_particle_update(Samples);
+
+	return Error;
+}
@@ -0,0 +1,96 @@
+// Compares the sprite model matrix chain SpriteRenderer used to build
+// (translate/translate/rotate/translate/scale on a mat4, then transforming
+// the quad corners) with the 2D affine fast path and its SSE batch variant.
+//
+// compile:
+// clang++ -std=c++17 -O2 ./bench/perf_sprite_transform.cpp -I ./include/ -I ./thirdparty/old/glm -o perf_sprite_transform
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+
+#include "SpriteTransform.h"
+
+static void test_glm_chain(std::vector<SpriteTransform> const& I, std::vector<glm::vec2>& O)
+{
+	for (std::size_t i = 0, n = I.size(); i < n; ++i)
+	{
+		glm::mat4 model = glm::mat4(1.0f);
+		model = glm::translate(model, glm::vec3(I[i].Position, 0.0f));
+		model = glm::translate(model, glm::vec3(0.5f * I[i].Size.x, 0.5f * I[i].Size.y, 0.0f));
+		model = glm::rotate(model, glm::radians(I[i].Rotate), glm::vec3(0.0f, 0.0f, 1.0f));
+		model = glm::translate(model, glm::vec3(-0.5f * I[i].Size.x, -0.5f * I[i].Size.y, 0.0f));
+		model = glm::scale(model, glm::vec3(I[i].Size, 1.0f));
+		O[i * 4 + 0] = glm::vec2(model * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+		O[i * 4 + 1] = glm::vec2(model * glm::vec4(1.0f, 0.0f, 0.0f, 1.0f));
+		O[i * 4 + 2] = glm::vec2(model * glm::vec4(0.0f, 1.0f, 0.0f, 1.0f));
+		O[i * 4 + 3] = glm::vec2(model * glm::vec4(1.0f, 1.0f, 0.0f, 1.0f));
+	}
+}
+
+static void test_affine(std::vector<SpriteTransform> const& I, std::vector<glm::vec2>& O)
+{
+	for (std::size_t i = 0, n = I.size(); i < n; ++i)
+		TransformSprite(I[i].Position, I[i].Size, I[i].Rotate, &O[i * 4]);
+}
+
+static void test_batch(std::vector<SpriteTransform> const& I, std::vector<glm::vec2>& O)
+{
+	TransformSprites(I.data(), static_cast<unsigned int>(I.size()), O.data());
+}
+
+static int launch(void (*Test)(std::vector<SpriteTransform> const&, std::vector<glm::vec2>&), std::vector<SpriteTransform> const& I, std::vector<glm::vec2>& O)
+{
+	O.resize(I.size() * 4);
+
+	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+	Test(I, O);
+	std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+
+	return static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count());
+}
+
+static int comp_sprite_transform(std::size_t Samples, float RotatedRatio)
+{
+	int Error = 0;
+
+	std::vector<SpriteTransform> I(Samples);
+	for (std::size_t i = 0; i < Samples; ++i)
+	{
+		I[i].Position = glm::vec2(static_cast<float>(i % 800), static_cast<float>(i % 600));
+		I[i].Size = glm::vec2(60.0f + static_cast<float>(i % 7), 20.0f + static_cast<float>(i % 5));
+		I[i].Rotate = static_cast<float>(i % 100) < RotatedRatio * 100.0f ? static_cast<float>(i % 360) : 0.0f;
+	}
+
+	std::vector<glm::vec2> Chain, Affine, Batch;
+	std::printf("- glm mat4 chain: %d us\n", launch(test_glm_chain, I, Chain));
+	std::printf("- 2D affine:      %d us\n", launch(test_affine, I, Affine));
+	std::printf("- batch (SIMD):   %d us\n", launch(test_batch, I, Batch));
+
+	for (std::size_t i = 0; i < Chain.size(); ++i)
+	{
+		Error += glm::all(glm::lessThan(glm::abs(Chain[i] - Affine[i]), glm::vec2(0.01f))) ? 0 : 1;
+		Error += glm::all(glm::lessThan(glm::abs(Chain[i] - Batch[i]), glm::vec2(0.01f))) ? 0 : 1;
+	}
+
+	return Error;
+}
+
+int main()
+{
+	std::size_t const Samples = 100000;
+
+	int Error = 0;
+
+	std::printf("unrotated sprites:\n");
+	Error += comp_sprite_transform(Samples, 0.0f);
+
+	std::printf("10%% rotated sprites:\n");
+	Error += comp_sprite_transform(Samples, 0.1f);
+
+	std::printf("all rotated sprites:\n");
+	Error += comp_sprite_transform(Samples, 1.0f);
+
+	return Error;
+}
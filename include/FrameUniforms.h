@@ -0,0 +1,42 @@
+#ifndef FRAMEUNIFORMS_H
+#define FRAMEUNIFORMS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "shader.h"
+
+// binding point of the uniform block shared by all shaders
+const unsigned int FRAME_UNIFORM_BINDING = 0;
+
+// CPU side of the std140 "Frame" uniform block; member order and padding
+// must match the block declared in the shaders
+struct FrameData {
+    glm::mat4 Projection;       // orthographic projection of the game board
+    glm::vec4 Viewport;         // width, height, 1/width, 1/height in pixels
+    float     Time;             // seconds since start
+    int       Chaos, Confuse, Shake;  // post-processing effect flags (std140 bools are 4 bytes)
+};
+
+// Owns the uniform buffer holding the per-frame and per-view constants.
+// Every shader declaring the block is attached once with Attach; changing
+// the projection, viewport or effects is then a single buffer update.
+class FrameUniforms
+{
+public:
+    // current contents, uploaded by Upload
+    FrameData Data;
+    // constructor/destructor
+    FrameUniforms();
+    ~FrameUniforms();
+    // connects the shader's "Frame" block to the shared binding point
+    void Attach(Shader &shader);
+    // sets the projection and viewport for a view of the given size
+    void SetView(const glm::mat4 &projection, unsigned int width, unsigned int height);
+    // writes Data to the GPU; call once per frame after changing it
+    void Upload();
+private:
+    unsigned int UBO;
+};
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef GLSTATE_H
+#define GLSTATE_H
+
+#include <glad/glad.h>
+
+// number of texture units whose 2D binding is tracked
+const unsigned int MAX_TRACKED_TEXTURE_UNITS = 8;
+
+// A static GL state tracker. Program, texture, vertex array and blend
+// changes go through it and calls that wouldn't change the driver's state
+// are skipped. Code that changes tracked state directly has to call
+// Invalidate afterwards. All functions are static, like ResourceManager.
+class GLState
+{
+public:
+    // statistics for the current frame
+    static unsigned int Issued;  // calls forwarded to GL
+    static unsigned int Skipped; // redundant calls that were dropped
+    // sets the active shader program
+    static void UseProgram(unsigned int program);
+    // selects the texture unit used by BindTexture (unit is GL_TEXTURE0 + n)
+    static void ActiveTexture(unsigned int unit);
+    // binds a GL_TEXTURE_2D texture on the active unit
+    static void BindTexture(unsigned int texture);
+    // deletes a texture; GL unbinds it from every unit, so the tracked bindings forget it too
+    static void DeleteTexture(unsigned int texture);
+    // binds a vertex array object
+    static void BindVertexArray(unsigned int vertexArray);
+    // deletes a vertex array object; GL reverts the binding to 0 if it was bound, so the tracked binding does too
+    static void DeleteVertexArray(unsigned int vertexArray);
+    // sets the blend function
+    static void BlendFunc(unsigned int sfactor, unsigned int dfactor);
+    // forgets everything, so the next call of each kind is always issued
+    static void Invalidate();
+    // resets the Issued/Skipped counters; call once per frame
+    static void ResetFrameCounters();
+private:
+    // private constructor, only static members
+    GLState() { }
+    // tracked state (~0u means unknown)
+    static unsigned int program;
+    static unsigned int activeUnit;
+    static unsigned int textures[MAX_TRACKED_TEXTURE_UNITS];
+    static unsigned int vertexArray;
+    static unsigned int blendSrc, blendDst;
+};
+
+#endif
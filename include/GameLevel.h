@@ -3,22 +3,100 @@
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <cstdint>
 #include <vector>
 #include "GameObject.h"
 #include "SpriteRenderer.h"
 #include "resource_manager.hpp"
 
+// per-brick data stored in the level's instance buffer
+struct BrickInstance {
+    glm::vec4 Rect;     // position, size
+    glm::vec4 Color;    // alpha 0 hides a destroyed brick
+    glm::vec4 TexRect;  // uv origin, uv size
+};
+
+// a run of instances that share a texture, drawn with one instanced call
+struct BrickBatch {
+    unsigned int Texture;
+    bool Solid;
+    unsigned int First, Count;
+};
+
+// the look of one kind of brick, shared by every brick of that kind
+struct BrickStyle {
+    glm::vec3 Color;
+    SubTexture Sprite;
+    bool Solid;
+};
+
+// A level of bricks on a regular grid. Bricks are stored as a structure of
+// arrays: a brick is its grid cell and a style index, its position and size
+// follow from the cell, and destroyed bricks are a bitset. The destructible
+// bricks left are counted as they are destroyed, so completion is O(1).
 class GameLevel
 {
     public:
-        std::vector<GameObject> Bricks;
+        // statistics (reset by ResetStats, usually once per frame)
+        unsigned int DrawCalls;
+        // constructor/destructor; a level owns its vertex array and buffers, so it can be moved but not copied
         GameLevel();
+        ~GameLevel();
+        GameLevel(const GameLevel &) = delete;
+        GameLevel &operator=(const GameLevel &) = delete;
+        GameLevel(GameLevel &&other);
+        GameLevel &operator=(GameLevel &&other);
         void Load(const char *file, unsigned int levelWidth, unsigned int levelHeight);
+        // draws the destructible bricks
         void Draw(SpriteRenderer &renderer);
-        bool IsCompleted();
+        // draws the solid bricks; they never change, so this is meant for a cached static layer
+        void DrawStatic(SpriteRenderer &renderer);
+        bool IsCompleted() const;
+        // marks a brick destroyed and patches only its slot of the instance buffer
+        void DestroyBrick(unsigned int index);
+        // number of bricks, solid ones included
+        unsigned int BrickCount() const;
+        // destructible bricks that are still standing
+        unsigned int BricksLeft() const;
+        // brick properties; every brick fills one grid cell
+        glm::vec2 BrickPosition(unsigned int index) const;
+        glm::vec2 BrickSize() const;
+        glm::vec3 BrickColor(unsigned int index) const;
+        bool IsSolid(unsigned int index) const;
+        bool IsDestroyed(unsigned int index) const;
+        // collects the bricks (destroyed ones included) whose grid cells overlap the box, in index order
+        void Query(glm::vec2 min, glm::vec2 max, std::vector<unsigned int> &bricks) const;
+
+        void ResetStats();
     private:
+        // brick storage, indexed by brick
+        std::vector<uint16_t> column, row;  // grid cell
+        std::vector<uint8_t> style;         // index into styles
+        std::vector<uint64_t> destroyed;    // one bit per brick
+        unsigned int bricksLeft;
+        std::vector<BrickStyle> styles;
+        // instanced render state
+        Shader shader;
+        unsigned int VAO, quadVBO, instanceVBO;
+        std::vector<unsigned int> slots;      // brick index -> instance slot
+        std::vector<unsigned int> slotBricks; // instance slot -> brick index
+        std::vector<BrickBatch> batches;
+        // range of instance slots modified since the last upload
+        unsigned int dirtyBegin, dirtyEnd;
+        // grid of the level file: row-major cell -> brick index, -1 for empty cells
+        std::vector<int> cells;
+        unsigned int columns, rows;
+        glm::vec2 cellSize;
+
         void init(std::vector< std::vector<unsigned int> > tileData, unsigned int levelWidth, unsigned int levelHeight);
-   
+        // (re)builds the instance buffer from the bricks
+        void initRenderData();
+        // deletes the vertex array and buffers
+        void releaseRenderData();
+        // the instance data of a brick
+        BrickInstance instance(unsigned int index) const;
+        // draws the batches of solid or of destructible bricks
+        void drawBatches(SpriteRenderer &renderer, bool solid);
 };
 
 
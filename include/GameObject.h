@@ -5,23 +5,28 @@
 #include <glm/glm.hpp>
 #include "texture.h"
 #include "SpriteRenderer.h"
+#include "RenderQueue.h"
 
 class GameObject
 {
     public:
         glm::vec2 Position, Size, Velocity;
+        // position at the start of the current simulation tick; drawing blends from it to Position
+        glm::vec2 PrevPosition;
         glm::vec3 Color;
         float Rotation;
         bool IsSolid;
         bool Destroyed;
-        Texture2D Sprite;
+        SubTexture Sprite;
 
         GameObject();
-        GameObject(glm::vec2 pos, glm::vec2 size, Texture2D sprite, 
+        GameObject(glm::vec2 pos, glm::vec2 size, SubTexture sprite, 
                     glm::vec3 color = glm::vec3(1.0f), 
                     glm::vec2 velocity = glm::vec2(0.0f, 0.0f));
         // virtual void Draw(SpriteRenderer &renderer);
         void Draw(SpriteRenderer &renderer);
+        // queues the object's sprite instead of drawing it right away, alpha of the way from PrevPosition to Position
+        void Draw(RenderQueue &queue, unsigned int layer, unsigned int depth = 0, float alpha = 1.0f);
 };
 
 
@@ -0,0 +1,58 @@
+#ifndef PARTICLE_FEEDBACK_H
+#define PARTICLE_FEEDBACK_H
+
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "shader.h"
+
+// a particle as stored in the GPU buffers; matches the outputs of particle_update.vs
+struct GPUParticle {
+    glm::vec2 Position, Velocity;
+    glm::vec4 Color;
+    float Life;
+};
+
+// Particle state kept entirely in GPU memory. Two buffers are ping-ponged:
+// every update runs particle_update.vs over the current buffer with
+// rasterization discarded and captures the result into the other one with
+// transform feedback. Spawned particles are written into a ring of slots,
+// so a full buffer replaces its oldest particles.
+class ParticleFeedback
+{
+public:
+    // constructor/destructor; quadVBO holds the particle quad read by particle.vs
+    ParticleFeedback(Shader updateShader, unsigned int capacity, unsigned int quadVBO, float fadeRate = 2.5f);
+    ~ParticleFeedback();
+    // number of slots
+    unsigned int Capacity() const;
+    // slots that have held a particle so far, all of them are drawn
+    unsigned int Used() const;
+    // live particles, tracked on the CPU from the spawn times so nothing is read back
+    unsigned int Live() const;
+    // queues a particle; queued particles are uploaded by the next update
+    void Spawn(glm::vec2 position, glm::vec2 velocity, glm::vec4 color, float life);
+    // uploads the queued particles and advances every slot on the GPU
+    void Update(float dt);
+    // binds the vertex array drawing the current buffer as particle.vs instances and returns the instance count
+    unsigned int Bind();
+private:
+    // state
+    Shader updateShader;
+    unsigned int capacity;
+    float fadeRate;
+    int dtLocation, fadeLocation;
+    unsigned int buffers[2], updateVAOs[2], renderVAOs[2];
+    unsigned int current;  // buffer holding the latest state
+    unsigned int next;     // ring slot for the next spawned particle
+    unsigned int used;
+    unsigned int live;
+    std::vector<GPUParticle> spawns;
+    // simulated time and the time each slot's particle dies; double so a frame's dt still registers after hours of play
+    double clock;
+    std::vector<double> deaths;
+    // writes count queued particles, starting at spawns[first], to consecutive slots of the current buffer
+    void upload(unsigned int slot, unsigned int first, unsigned int count);
+};
+
+#endif
@@ -7,39 +7,64 @@
 #include "shader.h"
 #include "texture.h"
 #include "GameObject.h"
+#include "StreamBuffer.h"
+#include "ParticlePool.h"
+#include "ParticleFeedback.h"
 
-// Represents a single particle and its state
-struct Particle {
-    glm::vec2 Position, Velocity;
+// per-instance data of a live particle as read by particle.vs
+struct ParticleInstance {
+    glm::vec2 Offset;
     glm::vec4 Color;
-    float Life;
-    // initialize
-    Particle() : Position(0.0f), Velocity(0.0f), Color(1.0f), Life(0.0f) { }
 };
 
+// Emits particles from a game object and draws them with one instanced call.
+// The particles are simulated either on the CPU (ParticlePool) or, when an
+// update shader is given, on the GPU with transform feedback (ParticleFeedback).
 class ParticleGenerator
 {
 public:
-    // constructor
-    ParticleGenerator(Shader shader, Texture2D texture, unsigned int amount);
+    // statistics (reset by ResetStats, usually once per frame)
+    unsigned int DrawCalls;
+    // constructor/destructor; CPU backend
+    ParticleGenerator(Shader shader, Texture2D texture, unsigned int amount, OverflowPolicy overflow = OVERFLOW_STEAL_OLDEST);
+    // GPU backend, particles are advanced by updateShader (particle_update.vs) and a full buffer replaces its oldest particles
+    ParticleGenerator(Shader shader, Shader updateShader, Texture2D texture, unsigned int amount);
+    ~ParticleGenerator();
     // update all particles
     void Update(float dt, GameObject &object, unsigned int newParticles, glm::vec2 offset = glm::vec2(0.0f, 0.0f));
-    // render all particles
+    // advances all particles without emitting new ones
+    void Update(float dt);
+    // emits a single particle; it moves against velocity, like the ball trail
+    void Spawn(glm::vec2 position, glm::vec2 velocity, glm::vec4 color, float life);
+    // live particles and the number of slots
+    unsigned int Count() const;
+    unsigned int Capacity() const;
+    // render all live particles with one instanced draw call
     void Draw();
+    void ResetStats();
+    // the CPU particle storage (live count, overflow policy and spawn statistics); empty with the GPU backend
+    const ParticlePool &GetPool() const;
+    // whether particles are simulated on the GPU
+    bool OnGPU() const;
 private:
     // state
-    std::vector<Particle> particles;
+    ParticlePool particles;
+    // number of particles the instance buffer has room for; follows the pool when it grows
     unsigned int amount;
     // render state
     Shader shader;
     Texture2D texture;
-    unsigned int VAO;
+    unsigned int VAO, quadVBO;
+    // live particles are streamed into this ring every frame
+    StreamBuffer *instanceBuffer;
+    // GPU particle state, nullptr with the CPU backend
+    ParticleFeedback *feedback;
     // initializes buffer and vertex attributes
     void init();
-    // returns the first Particle index that's currently unused e.g. Life <= 0.0f or 0 if no particle is currently inactive
-    unsigned int firstUnusedParticle();
-    // respawns particle
-    void respawnParticle(Particle &particle, GameObject &object, glm::vec2 offset = glm::vec2(0.0f, 0.0f));
+    // streams the live CPU particles and binds them as instances; returns the instance count
+    unsigned int bindInstances();
+    // spawns a particle at the object
+    void respawnParticle(GameObject &object, glm::vec2 offset = glm::vec2(0.0f, 0.0f));
 };
 
 #endif
\ No newline at end of file
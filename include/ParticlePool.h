@@ -0,0 +1,54 @@
+#ifndef PARTICLE_POOL_H
+#define PARTICLE_POOL_H
+
+#include <vector>
+#include <glm/glm.hpp>
+
+// what Spawn does when every slot is live
+enum OverflowPolicy {
+    OVERFLOW_DROP,          // the new particle is discarded
+    OVERFLOW_STEAL_OLDEST,  // the oldest live particle is replaced
+    OVERFLOW_GROW           // the pool doubles its capacity
+};
+
+// Structure-of-arrays particle storage. Live particles always occupy
+// slots [0, Live): every update compacts dead particles away (keeping the
+// remaining ones in spawn order), so neither the update kernel nor the
+// renderer ever touches a dead slot and spawning is a plain append.
+// All state is per pool, so any number of pools can be used side by side.
+class ParticlePool
+{
+public:
+    // particle state, one array per component
+    std::vector<float> X, Y, VX, VY, R, G, B, A, Life;
+    // number of live particles
+    unsigned int Live;
+    // alpha lost per second
+    float FadeRate;
+    OverflowPolicy Overflow;
+    // spawn statistics
+    unsigned int Spawned, Dropped, Stolen, Grown;
+    // constructor
+    ParticlePool(unsigned int capacity, float fadeRate = 2.5f, OverflowPolicy overflow = OVERFLOW_STEAL_OLDEST);
+    // number of slots
+    unsigned int Capacity() const;
+    // appends a particle in O(1), applying the overflow policy if the pool is full; returns false if it was dropped
+    bool Spawn(glm::vec2 position, glm::vec2 velocity, glm::vec4 color, float life);
+    // overwrites the particle in the given live slot
+    void Set(unsigned int index, glm::vec2 position, glm::vec2 velocity, glm::vec4 color, float life);
+    // advances all live particles (vectorized where available) and compacts dead ones away
+    void Update(float dt);
+    // same as Update with the scalar kernel only (reference/benchmarking)
+    void UpdateScalar(float dt);
+    // resets the spawn statistics
+    void ResetStats();
+private:
+    // next slot to steal; walks the live slots in spawn order and is kept pointing at the same particle by compact()
+    unsigned int stealCursor;
+    // resizes every component array
+    void resize(unsigned int capacity);
+    // removes dead particles while keeping the order of the live ones
+    void compact();
+};
+
+#endif
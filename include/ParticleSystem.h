@@ -0,0 +1,74 @@
+#ifndef PARTICLE_SYSTEM_H
+#define PARTICLE_SYSTEM_H
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "GameObject.h"
+#include "ParticleGenerator.h"
+
+// A lightweight particle source. Continuous emitters spawn Rate particles per
+// second; bursts spawn all of their particles on the next update.
+struct ParticleEmitter {
+    glm::vec2 Position;       // spawn origin, tracks Follow when set
+    glm::vec2 Offset;         // added to the followed object's position
+    glm::vec2 Velocity;       // base velocity; particles move against it
+    float Speed;              // random velocity in any direction, up to this many pixels per second
+    float Spread;             // random position jitter, +/- pixels
+    glm::vec3 Color;          // base color, each particle gets a random brightness
+    float Life;               // particle lifetime in seconds
+    float Rate;               // particles per second
+    unsigned int Burst;       // particles emitted at once by the next update
+    float Duration;           // seconds until the emitter is removed, negative to keep it
+    GameObject *Follow;       // optional object the emitter is attached to (trails)
+    float VelocityScale;      // fraction of the followed object's velocity given to its particles
+    // runtime state
+    float Accumulator;
+    bool Alive;
+    ParticleEmitter();
+};
+
+// Owns one particle generator (and so one pool and one draw call) shared by
+// any number of emitters. A global budget throttles emission: past half the
+// budget every emitter's output is scaled down linearly, reaching zero when
+// the budget is full, so bursts under load get thinner instead of stealing
+// live particles.
+class ParticleSystem
+{
+public:
+    // maximum number of live particles
+    unsigned int Budget;
+    // current emission scale (1 = unthrottled) and particles skipped because of the budget (reset by ResetStats)
+    float Throttle;
+    unsigned int Throttled;
+    // constructor/destructor; the system takes ownership of the generator
+    ParticleSystem(ParticleGenerator *generator, unsigned int budget);
+    ~ParticleSystem();
+    // adds an emitter and returns its handle
+    unsigned int AddEmitter(const ParticleEmitter &emitter);
+    // access an emitter through its handle
+    ParticleEmitter &GetEmitter(unsigned int handle);
+    void RemoveEmitter(unsigned int handle);
+    // one-shot burst of count particles flying out of position
+    void Burst(glm::vec2 position, unsigned int count, glm::vec3 color, float speed = 150.0f, float life = 0.6f);
+    // runs all emitters and advances the particles
+    void Update(float dt);
+    // draws every particle with a single instanced call
+    void Draw();
+    // number of live particles
+    unsigned int Count() const;
+    // number of emitters in use
+    unsigned int Emitters() const;
+    // the shared generator (draw statistics, capacity)
+    ParticleGenerator &GetGenerator();
+    // resets the throttling and the generator's statistics; call once per frame
+    void ResetStats();
+private:
+    ParticleGenerator *generator;
+    std::vector<ParticleEmitter> emitters;
+    // slots of removed emitters, reused by AddEmitter
+    std::vector<unsigned int> freeEmitters;
+    // emits count particles from an emitter
+    void emit(const ParticleEmitter &emitter, unsigned int count);
+};
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef PERF_OVERLAY_H
+#define PERF_OVERLAY_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "texture.h"
+#include "SpriteRenderer.h"
+#include "TextRenderer.h"
+
+// frames shown in the frame time graph
+const unsigned int PERF_GRAPH_FRAMES = 240;
+// frames the 1% and 0.1% lows are taken over
+const unsigned int PERF_LOW_FRAMES = 2000;
+
+// counters of one frame, gathered by the game from its renderers
+struct PerfCounters {
+    float CPUMilliseconds, GPUMilliseconds;  // this frame's, unsmoothed
+    unsigned int DrawCalls;
+    unsigned int Blits;             // framebuffer blits, not in DrawCalls
+    unsigned int StateChanges;      // GL state calls issued
+    unsigned int SkippedChanges;    // redundant GL state calls dropped
+    unsigned int QueueStateChanges; // switches between consecutive render queue commands
+    unsigned int Particles, ParticleCapacity;
+    unsigned int Bricks, BricksTotal;
+    unsigned int PowerUps;          // active power-ups
+    size_t TextureBytes;
+    float Scale;
+    unsigned int Samples;
+    std::string LastResolutionChange;
+};
+
+// A toggleable overlay with a rolling graph of CPU and GPU frame times and
+// the frame's counters. Frames are recorded whether the overlay is visible or
+// not, so the lows are meaningful as soon as it is shown. The text is only
+// rebuilt a few times a second, which keeps the numbers readable, and is laid
+// out uncached; the graph is a single sprite batch of a 1x1 white texture.
+class PerfOverlay
+{
+public:
+    bool Visible;
+    // top-left corner of the overlay
+    glm::vec2 Position;
+    // frame time at the top of the graph and the budget line, in milliseconds
+    float GraphMilliseconds, BudgetMilliseconds;
+    // cpu time the overlay itself took to draw in the last frame
+    float OwnMilliseconds;
+    // constructor/destructor
+    PerfOverlay(float budgetMilliseconds = 1000.0f / 60.0f);
+    ~PerfOverlay();
+    // records a frame; call once per frame, also when hidden
+    void Frame(const PerfCounters &counters);
+    // draws the graph and queues the text; the text shows up with the TextRenderer's next Flush
+    void Draw(SpriteRenderer &renderer, TextRenderer &text);
+private:
+    SubTexture white;
+    // rings of wall clock frame times and gpu times, in milliseconds
+    std::vector<float> frameTimes, gpuTimes;
+    unsigned int frames;  // frames recorded so far
+    double lastFrame, lastRefresh;  // lastFrame is negative until the first Frame
+    // the most recent counters and the text built from them
+    PerfCounters counters;
+    std::vector<std::string> lines;
+    // scratch space for the lows
+    std::vector<float> sorted;
+    // rebuilds the text lines
+    void refresh();
+    // the frame time exceeded by the given fraction of the recorded frames
+    float low(float fraction);
+};
+
+#endif
@@ -1,41 +1,113 @@
 #ifndef POSTPROCESSOR_H
 #define POSTPROCESSOR_H
 
+#include <cstddef>
+#include <string>
+#include <vector>
+
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
 #include "texture.h"
 #include "SpriteRenderer.h"
 #include "shader.h"
+#include "RenderTargetPool.h"
+
+// maximum radius of a separable blur pass
+const int MAX_POST_RADIUS = 16;
 
+// One step of the post-processing chain. Every pass reads the previous
+// pass' output through its own fragment shader (post.vs places the quad),
+// so a pass never pays for the others' effects.
+struct PostPass {
+    std::string Name;
+    bool        Enabled;
+    Shader      Program;
+    // separable passes run twice, horizontally then vertically, with binomial weights over Radius taps per side
+    bool        Separable;
+    int         Radius;
+    // distance between taps in texture coordinates
+    glm::vec2   Texel;
+    // texture coordinate transform and animation, applied once per pass
+    glm::vec2   UVScale, UVOffset;
+    float       Swirl, Jitter;
+    // uniform locations, looked up once by AddPass
+    int         RegionLocation = -1, UVScaleLocation = -1, UVOffsetLocation = -1, SwirlLocation = -1, JitterLocation = -1;
+    int         TexelLocation = -1, RadiusLocation = -1, WeightsLocation = -1;
+};
 
+// Renders the scene into a multisampled buffer and runs it through an
+// ordered chain of passes; the last enabled pass writes to the screen and
+// intermediate results go to pooled ping-pong targets. The scene can be
+// rendered into a smaller part of the buffers (Scale) with fewer samples;
+// the chain then works on that region and the last pass upscales it.
 class PostProcessor
 {
 public:
     // state
-    Shader PostProcessingShader;
+    Shader BlitShader;
     Texture2D Texture;
+    std::vector<PostPass> Passes;
 
     unsigned int Width, Height;
-    // options
+    // fraction of Width/Height the scene is rendered at and the MSAA sample count (1 = no multisampling)
+    float Scale;
+    unsigned int Samples;
+    // the game's effect switches, mapped onto passes of the chain by the game
     bool Confuse, Chaos, Shake;
+    // set by EndRender when no effect was on and the frame went straight to the screen
+    bool Bypassed;
+    // statistics (reset by ResetStats, usually once per frame): quads drawn and framebuffer blits
+    unsigned int DrawCalls, Blits;
 
     // constructor
-    PostProcessor(Shader shader, unsigned int width, unsigned int height);
+    PostProcessor(Shader blitShader, unsigned int width, unsigned int height);
+
+    // appends a pass to the chain (disabled, no transform) and returns its index into Passes;
+    // an index stays valid while later passes are added, a reference would not
+    unsigned int AddPass(std::string name, Shader program, bool separable = false, int radius = 0);
+    // looks up a pass by name (nullptr if there is none)
+    PostPass *GetPass(const std::string &name);
 
-    // prepares the postprocessor's framebuffer operations before rendering the game
-    void BeginRender();
+    // changes the internal resolution; takes effect with the next BeginRender
+    void SetScale(float scale);
+    // changes the MSAA sample count (clamped to what the driver supports), reallocating the multisampled buffer
+    void SetSamples(unsigned int samples);
+    // reallocates all buffers for a new framebuffer size
+    void Resize(unsigned int width, unsigned int height);
+    // size of the region the scene is rendered into
+    unsigned int RenderWidth() const;
+    unsigned int RenderHeight() const;
 
-    // should be called after rendering the game, so it stores all the rendered data into a texture object
+    // prepares the postprocessor's framebuffer operations before rendering the game and sets the viewport to the render region;
+    // a cached static layer (e.g. background) is drawn first with a single full-screen quad
+    void BeginRender(const Texture2D *underlay = nullptr);
+
+    // should be called after rendering the game, so it stores all the rendered data into a texture object;
+    // without an active effect the scene is resolved straight into the default framebuffer instead
     void EndRender();
     
-    // renders the PostProcessor texture quad (as a screen-encompassing large sprite)
-    void Render(float time);
+    // runs the enabled passes in order, the last one onto the screen; does nothing for a bypassed frame
+    void Render();
+
+    // whether any pass of the chain is enabled
+    bool Active() const;
+    // estimated video memory of the multisampled buffer, the resolve texture and the pooled targets
+    size_t TextureBytes() const;
+
+    void ResetStats();
 private:
     // render state
     unsigned int MSFBO, FBO; // MSFBO = Multisampled FBO. FBO is regular, used for blitting MS color-buffer to texture
     unsigned int RBO; // RBO is used for multisampled color buffer
     unsigned int VAO;
+    unsigned int maxSamples;
+    // screen viewport saved by BeginRender
+    int viewport[4];
+    // intermediate targets shared by all passes
+    RenderTargetPool targets;
+    // draws one (sub)pass reading source into the bound framebuffer
+    void drawPass(const PostPass &pass, const Texture2D &source, glm::vec2 direction, bool transform, glm::vec2 region);
     // initialize quad for rendering postprocessing texture
     void initRenderData();
 };
@@ -17,7 +17,7 @@ public:
     float       Duration;	
     bool        Activated;
     // constructor
-    PowerUp(std::string type, glm::vec3 color, float duration, glm::vec2 position, Texture2D texture) 
+    PowerUp(std::string type, glm::vec3 color, float duration, glm::vec2 position, SubTexture texture) 
         : GameObject(position, SIZE, texture, color, VELOCITY), Type(type), Duration(duration), Activated(){ }
 };  
 
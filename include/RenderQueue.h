@@ -0,0 +1,72 @@
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "texture.h"
+#include "SpriteRenderer.h"
+
+// coarse draw order; everything in a lower layer is drawn before a higher one
+enum RenderLayer {
+    LAYER_LEVEL,
+    LAYER_OBJECTS,
+    LAYER_PARTICLES,
+    LAYER_BALL
+};
+
+// blend modes a command can request
+enum BlendMode {
+    BLEND_ALPHA,
+    BLEND_ADDITIVE
+};
+
+// A single draw: either a sprite that goes through the SpriteRenderer
+// batch, or a callback for things with their own draw path (instanced
+// bricks, particles). Commands only live until the queue is submitted, so
+// the sprite is referenced rather than copied.
+struct RenderCommand {
+    uint64_t Key;
+    const SubTexture *Sprite;
+    glm::vec2 Position, Size;
+    float Rotate;
+    glm::vec3 Color;
+    std::function<void()> Callback;
+};
+
+// Collects the frame's draws, sorts them by a packed 64-bit key and submits
+// them in one go. The key is, from most to least significant bits:
+//   layer (8) | blend (2) | shader (8) | texture (16) | depth (16) | unused (14)
+// so order is kept between layers (and by depth inside a layer only when
+// shader and texture match), while state changes are grouped everywhere else.
+class RenderQueue
+{
+public:
+    // statistics of the last Submit
+    unsigned int Commands;
+    unsigned int StateChanges; // blend, shader or texture switches between consecutive commands
+    // constructor
+    RenderQueue();
+    // packs the sort key
+    static uint64_t MakeKey(unsigned int layer, unsigned int blend, unsigned int shader, unsigned int texture, unsigned int depth);
+    // queues a sprite drawn by the SpriteRenderer's shader; sprite has to stay alive until Submit
+    void PushSprite(unsigned int layer, unsigned int depth, const SubTexture &sprite, glm::vec2 position,
+                    glm::vec2 size, float rotate = 0.0f, glm::vec3 color = glm::vec3(1.0f), unsigned int blend = BLEND_ALPHA);
+    // queues a custom draw; the callback must leave alpha blending enabled
+    void PushCallback(uint64_t key, std::function<void()> callback);
+    // sorts and draws everything queued, then clears the queue
+    void Submit(SpriteRenderer &renderer);
+private:
+    std::vector<RenderCommand> commands;
+    // radix sort scratch space: (key, command index) pairs
+    std::vector<uint64_t> keys, keysTemp;
+    std::vector<unsigned int> order, orderTemp;
+    // stable LSD radix sort of the commands' keys into order
+    void sort();
+};
+
+#endif
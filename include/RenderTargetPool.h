@@ -0,0 +1,40 @@
+#ifndef RENDERTARGETPOOL_H
+#define RENDERTARGETPOOL_H
+
+#include <cstddef>
+#include <vector>
+#include <glad/glad.h>
+
+#include "texture.h"
+
+// an offscreen color target
+struct RenderTarget {
+    unsigned int FBO;
+    Texture2D Texture;
+    unsigned int Width, Height;
+    bool InUse;
+};
+
+// Hands out offscreen color targets for intermediate passes. Released
+// targets are kept and reused by later passes and frames, so a chain of
+// passes ping-pongs between a couple of framebuffers instead of creating
+// new ones.
+class RenderTargetPool
+{
+public:
+    ~RenderTargetPool();
+    // returns a free target of the given size, creating one if none is left
+    RenderTarget *Acquire(unsigned int width, unsigned int height);
+    // gives a target back to the pool
+    void Release(RenderTarget *target);
+    // deletes all targets (e.g. after a resize)
+    void Clear();
+    // number of targets allocated
+    unsigned int Size() const;
+    // estimated video memory of the allocated targets
+    size_t TextureBytes() const;
+private:
+    std::vector<RenderTarget*> targets;
+};
+
+#endif
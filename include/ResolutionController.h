@@ -0,0 +1,64 @@
+#ifndef RESOLUTIONCONTROLLER_H
+#define RESOLUTIONCONTROLLER_H
+
+#include <deque>
+#include <string>
+
+#include <glad/glad.h>
+
+// number of GPU timer queries in flight; results are read a few frames late so reading never stalls
+const unsigned int RESOLUTION_TIMER_QUERIES = 4;
+
+// one change made by the controller, kept for inspection
+struct ResolutionChange {
+    double Time;            // seconds since start (glfwGetTime)
+    float Scale;            // resulting render scale
+    unsigned int Samples;   // resulting MSAA samples
+    float CPUMilliseconds;  // smoothed frame times that triggered the change
+    float GPUMilliseconds;
+    std::string Reason;
+};
+
+// Holds a frame time budget by adjusting the internal render resolution and
+// MSAA sample count. GPU time comes from GL_TIME_ELAPSED queries around the
+// frame, CPU time from the wall clock between BeginFrame and EndFrame. Over
+// budget on the GPU, samples are dropped first and then the scale; with
+// plenty of headroom they are restored in the opposite order. A frame that
+// is CPU bound is left alone, fewer pixels wouldn't help it.
+class ResolutionController
+{
+public:
+    // frame time to hold, in milliseconds
+    float BudgetMilliseconds;
+    // limits of the adjustments
+    float MinScale, MaxScale, ScaleStep;
+    unsigned int MaxSamples;
+    // current settings
+    float Scale;
+    unsigned int Samples;
+    // smoothed frame times
+    float CPUMilliseconds, GPUMilliseconds;
+    // unsmoothed times of the most recent measurements
+    float LastCPUMilliseconds, LastGPUMilliseconds;
+    // constructor/destructor
+    ResolutionController(float budgetMilliseconds = 1000.0f / 60.0f, unsigned int maxSamples = 4);
+    ~ResolutionController();
+    // brackets the frame's rendering; EndFrame updates the timings and may change Scale/Samples
+    void BeginFrame();
+    void EndFrame();
+    // the most recent changes, oldest first
+    const std::deque<ResolutionChange> &History() const;
+private:
+    unsigned int queries[RESOLUTION_TIMER_QUERIES];
+    unsigned int frame;       // frames since start, selects the query
+    unsigned int cooldown;    // frames left before the next change is allowed
+    bool cpuBound;
+    double frameStart;
+    std::deque<ResolutionChange> history;
+    // reads the oldest query if its result is ready
+    void collectGPUTime();
+    // stores a change (or an observation) in the history
+    void record(const std::string &reason);
+};
+
+#endif
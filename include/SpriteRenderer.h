@@ -1,27 +1,74 @@
 #ifndef SPRITERENDERER_H
 #define SPRITERENDERER_H
 
+#include <cstddef>
+#include <vector>
+
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
 #include "texture.h"
 #include "shader.h"
+#include "SpriteTransform.h"
+#include "StreamBuffer.h"
+
+// maximum number of quads collected before a batch is flushed
+const unsigned int MAX_BATCH_SPRITES = 1024;
+
+// a single pre-transformed vertex of a batched sprite quad
+struct SpriteVertex {
+    glm::vec2 Position;
+    glm::vec2 TexCoords;
+    glm::vec4 Color;
+};
 
-class SpriteRenderer 
+class SpriteRenderer
 {
     public:
+        // statistics (reset by ResetStats, usually once per frame)
+        unsigned int DrawCalls;
+        unsigned int SpritesDrawn;
+
         SpriteRenderer(Shader &shader);
         ~SpriteRenderer();
-        void DrawSprite(Texture2D &texture, glm::vec2 position,
+        // draws a sprite (a whole texture or an atlas region); inside a Begin/End pair the sprite is queued into the current batch
+        void DrawSprite(const SubTexture &sprite, glm::vec2 position,
+                    glm::vec2 size = glm::vec2(10.0f, 10.0f), float rotate = 0.0f, glm::vec3 color = glm::vec3(1.0f));
+
+        // starts collecting sprites into one streaming vertex buffer
+        void Begin();
+        // queues a sprite, flushing first if the texture changes or the batch is full
+        void Submit(const SubTexture &sprite, glm::vec2 position,
                     glm::vec2 size = glm::vec2(10.0f, 10.0f), float rotate = 0.0f, glm::vec3 color = glm::vec3(1.0f));
+        // draws all queued sprites with a single draw call
+        void Flush();
+        // flushes the remaining sprites and leaves batching mode
+        void End();
+        // hands the frame's vertex data over to the GPU; call once at the end of every frame
+        void EndFrame();
+        // the ring buffer all batches are streamed through (stall/wrap statistics)
+        const StreamBuffer &GetStream() const;
+
+        void ResetStats();
     private:
         // Render state
-        Shader shader; 
+        Shader shader;
         unsigned int quadVAO;
+        StreamBuffer *stream;
+        // batch state: placement, atlas region (uv origin, uv size) and color of every queued sprite;
+        // the corners are computed for the whole batch at once when it is flushed
+        std::vector<SpriteTransform> transforms;
+        std::vector<glm::vec4> regions;
+        std::vector<glm::vec4> colors;
+        std::vector<glm::vec2> corners;
+        unsigned int batchTexture;
+        bool batching;
 
         // Initializes and configures the quad's buffer and vertex attributes
         void initRenderData();
+        // forgets the queued sprites
+        void clearBatch();
 };
 
-#endif
\ No newline at end of file
+#endif
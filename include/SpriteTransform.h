@@ -0,0 +1,101 @@
+#ifndef SPRITETRANSFORM_H
+#define SPRITETRANSFORM_H
+
+#include <cmath>
+
+#include <glm/glm.hpp>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define SPRITE_TRANSFORM_SSE
+#include <xmmintrin.h>
+#endif
+
+// Placement of a sprite quad: top-left position, size and rotation (degrees)
+// around the quad's center, the same convention as SpriteRenderer::DrawSprite.
+struct SpriteTransform {
+    glm::vec2 Position;
+    glm::vec2 Size;
+    float     Rotate;
+};
+
+// Computes the four corners of a sprite quad (top-left, top-right,
+// bottom-left, bottom-right) as a 2D affine transform instead of composing
+// a mat4. Unrotated sprites, nearly all of them, only need two additions.
+inline void TransformSprite(glm::vec2 position, glm::vec2 size, float rotate, glm::vec2 corners[4])
+{
+    if (rotate == 0.0f)
+    {
+        corners[0] = position;
+        corners[1] = glm::vec2(position.x + size.x, position.y);
+        corners[2] = glm::vec2(position.x, position.y + size.y);
+        corners[3] = position + size;
+        return;
+    }
+    // rotate the half extents around the quad's center
+    float radians = glm::radians(rotate);
+    float c = std::cos(radians), s = std::sin(radians);
+    glm::vec2 half = 0.5f * size;
+    glm::vec2 center = position + half;
+    glm::vec2 axisX(c * half.x, s * half.x);
+    glm::vec2 axisY(-s * half.y, c * half.y);
+    corners[0] = center - axisX - axisY;
+    corners[1] = center + axisX - axisY;
+    corners[2] = center - axisX + axisY;
+    corners[3] = center + axisX + axisY;
+}
+
+// Batch variant: writes 4 corners per sprite into corners (count * 4 entries).
+// Four sprites are transformed per step with SSE where available.
+inline void TransformSprites(const SpriteTransform *sprites, unsigned int count, glm::vec2 *corners)
+{
+    unsigned int i = 0;
+#ifdef SPRITE_TRANSFORM_SSE
+    const __m128 half = _mm_set1_ps(0.5f);
+    for (; i + 4 <= count; i += 4)
+    {
+        const SpriteTransform *t = sprites + i;
+        // groups without rotation are only additions and stay scalar
+        if (t[0].Rotate == 0.0f && t[1].Rotate == 0.0f && t[2].Rotate == 0.0f && t[3].Rotate == 0.0f)
+        {
+            for (unsigned int j = 0; j < 4; ++j)
+                TransformSprite(t[j].Position, t[j].Size, 0.0f, &corners[(i + j) * 4]);
+            continue;
+        }
+        // sin/cos stay scalar and are skipped for unrotated sprites
+        float c[4], s[4];
+        for (unsigned int j = 0; j < 4; ++j)
+        {
+            float radians = glm::radians(t[j].Rotate);
+            c[j] = t[j].Rotate == 0.0f ? 1.0f : std::cos(radians);
+            s[j] = t[j].Rotate == 0.0f ? 0.0f : std::sin(radians);
+        }
+        __m128 cosv = _mm_loadu_ps(c), sinv = _mm_loadu_ps(s);
+        __m128 hx = _mm_mul_ps(half, _mm_setr_ps(t[0].Size.x, t[1].Size.x, t[2].Size.x, t[3].Size.x));
+        __m128 hy = _mm_mul_ps(half, _mm_setr_ps(t[0].Size.y, t[1].Size.y, t[2].Size.y, t[3].Size.y));
+        __m128 cx = _mm_add_ps(hx, _mm_setr_ps(t[0].Position.x, t[1].Position.x, t[2].Position.x, t[3].Position.x));
+        __m128 cy = _mm_add_ps(hy, _mm_setr_ps(t[0].Position.y, t[1].Position.y, t[2].Position.y, t[3].Position.y));
+        // rotated half axes
+        __m128 ax = _mm_mul_ps(cosv, hx), ay = _mm_mul_ps(sinv, hx);
+        __m128 bx = _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(sinv, hy)), by = _mm_mul_ps(cosv, hy);
+
+        __m128 tlx = _mm_sub_ps(_mm_sub_ps(cx, ax), bx), tly = _mm_sub_ps(_mm_sub_ps(cy, ay), by);
+        __m128 trx = _mm_sub_ps(_mm_add_ps(cx, ax), bx), try_ = _mm_sub_ps(_mm_add_ps(cy, ay), by);
+        __m128 blx = _mm_add_ps(_mm_sub_ps(cx, ax), bx), bly = _mm_add_ps(_mm_sub_ps(cy, ay), by);
+        __m128 brx = _mm_add_ps(_mm_add_ps(cx, ax), bx), bry = _mm_add_ps(_mm_add_ps(cy, ay), by);
+
+        // transpose from one register per coordinate to 8 floats per sprite
+        _MM_TRANSPOSE4_PS(tlx, tly, trx, try_);
+        _MM_TRANSPOSE4_PS(blx, bly, brx, bry);
+        float *out = &corners[i * 4].x;
+        _mm_storeu_ps(out +  0, tlx); _mm_storeu_ps(out +  4, blx);
+        _mm_storeu_ps(out +  8, tly); _mm_storeu_ps(out + 12, bly);
+        _mm_storeu_ps(out + 16, trx); _mm_storeu_ps(out + 20, brx);
+        _mm_storeu_ps(out + 24, try_); _mm_storeu_ps(out + 28, bry);
+    }
+#endif
+    // scalar remainder (or everything without SSE)
+    for (; i < count; ++i)
+        TransformSprite(sprites[i].Position, sprites[i].Size, sprites[i].Rotate, &corners[i * 4]);
+}
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef STATICLAYER_H
+#define STATICLAYER_H
+
+#include <cstddef>
+
+#include <glad/glad.h>
+
+#include "texture.h"
+
+// An offscreen texture for parts of the scene that don't change between
+// frames (background, solid bricks). It is redrawn only when its contents
+// change and composited underneath the dynamic scene every frame.
+class StaticLayer
+{
+public:
+    // rendered contents
+    Texture2D Texture;
+    unsigned int Width, Height;
+    // constructor/destructor
+    StaticLayer(unsigned int width, unsigned int height);
+    ~StaticLayer();
+    // redirects rendering into the layer and clears it
+    void Begin();
+    // restores the default framebuffer and viewport
+    void End();
+    // reallocates the layer's storage for a new size
+    void Resize(unsigned int width, unsigned int height);
+    // estimated video memory of the layer
+    size_t TextureBytes() const;
+private:
+    unsigned int FBO;
+    int viewport[4]; // viewport to restore in End
+};
+
+#endif
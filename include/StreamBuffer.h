@@ -0,0 +1,44 @@
+#ifndef STREAMBUFFER_H
+#define STREAMBUFFER_H
+
+#include <glad/glad.h>
+
+// number of ring segments; the GPU may still be reading the previous
+// STREAM_BUFFER_SEGMENTS - 1 frames while the CPU writes the next one
+const unsigned int STREAM_BUFFER_SEGMENTS = 3;
+
+// A ring buffer for geometry that is rewritten every frame. With
+// ARB_buffer_storage the buffer is mapped once (persistent + coherent)
+// and every segment is guarded by a fence; on plain GL 3.3 core it falls
+// back to unsynchronized mapping and orphans the buffer when the ring
+// wraps. Either way writing frame N never waits on frame N-1.
+class StreamBuffer
+{
+public:
+    // buffer object, bind it as vertex source; offsets returned by Map are relative to it
+    unsigned int ID;
+    // whether the persistent-mapped path is in use
+    bool Persistent;
+    // statistics (totals since construction)
+    unsigned int Stalls; // fence waits that actually had to block
+    unsigned int Wraps;  // times the ring wrapped back to its first segment
+    // constructor/destructor; segmentSize is the number of bytes per frame
+    StreamBuffer(unsigned int segmentSize, unsigned int target = GL_ARRAY_BUFFER);
+    ~StreamBuffer();
+    // reserves size bytes at an offset aligned to alignment and returns a pointer to write to
+    void *Map(unsigned int size, unsigned int alignment, unsigned int &offset);
+    // ends writing the last mapped range; call before drawing from it
+    void Unmap();
+    // fences the current segment and moves on to the next; call once per frame
+    void EndFrame();
+private:
+    unsigned int target;
+    unsigned int segmentSize;
+    unsigned int segment, head; // current segment and write position inside it
+    char *mapped;               // persistent mapping of the whole buffer
+    GLsync fences[STREAM_BUFFER_SEGMENTS];
+    // moves to the next segment, waiting for the GPU to release it if needed
+    void advance();
+};
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef SWEPTCOLLISION_H
+#define SWEPTCOLLISION_H
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include <glm/glm.hpp>
+
+// first contact of a moving circle with a box
+struct SweepHit {
+    float Time;       // fraction of the motion covered before the contact, in [0, 1]
+    glm::vec2 Normal; // unit surface normal of the box at the contact, pointing at the circle
+};
+
+// Sweeps a circle moving by motion against an axis aligned box. The circle
+// hits the box where its center enters the box grown by the radius, a
+// rectangle with rounded corners: a ray is tested against the grown box and,
+// when it enters through a corner region, against the corner's circle. A
+// circle already touching the box only hits it while moving further in.
+inline bool SweepCircleBox(glm::vec2 center, float radius, glm::vec2 motion, glm::vec2 boxMin, glm::vec2 boxMax, SweepHit &hit)
+{
+    // already touching
+    glm::vec2 offset = center - glm::clamp(center, boxMin, boxMax);
+    float distance2 = glm::dot(offset, offset);
+    if (distance2 <= radius * radius)
+    {
+        glm::vec2 normal;
+        if (distance2 > 0.0f)
+            normal = offset / std::sqrt(distance2);
+        else
+        {
+            // center inside the box: out through the nearest face
+            float faces[4] = { center.x - boxMin.x, boxMax.x - center.x, center.y - boxMin.y, boxMax.y - center.y };
+            const glm::vec2 normals[4] = { glm::vec2(-1.0f, 0.0f), glm::vec2(1.0f, 0.0f), glm::vec2(0.0f, -1.0f), glm::vec2(0.0f, 1.0f) };
+            normal = normals[std::min_element(faces, faces + 4) - faces];
+        }
+        if (glm::dot(motion, normal) >= 0.0f)
+            return false;
+        hit.Time = 0.0f;
+        hit.Normal = normal;
+        return true;
+    }
+
+    // ray against the grown box, one slab per axis
+    glm::vec2 lo = boxMin - radius, hi = boxMax + radius;
+    float enter = 0.0f, exit = 1.0f;
+    int axis = -1;
+    for (int a = 0; a < 2; ++a)
+    {
+        if (std::abs(motion[a]) < 1e-8f)
+        {
+            if (center[a] < lo[a] || center[a] > hi[a])
+                return false;
+            continue;
+        }
+        float t0 = (lo[a] - center[a]) / motion[a], t1 = (hi[a] - center[a]) / motion[a];
+        if (t0 > t1)
+            std::swap(t0, t1);
+        if (t0 > enter)
+        {
+            enter = t0;
+            axis = a;
+        }
+        exit = std::min(exit, t1);
+        if (enter > exit)
+            return false;
+    }
+
+    glm::vec2 point = center + motion * enter;
+    bool outsideX = point.x < boxMin.x || point.x > boxMax.x, outsideY = point.y < boxMin.y || point.y > boxMax.y;
+    if (axis >= 0 && !(outsideX && outsideY))
+    {
+        // entered through a face
+        hit.Time = enter;
+        hit.Normal = glm::vec2(0.0f);
+        hit.Normal[axis] = motion[axis] > 0.0f ? -1.0f : 1.0f;
+        return true;
+    }
+
+    // entered through a corner region, the circle has to hit that corner
+    glm::vec2 corner = glm::clamp(point, boxMin, boxMax);
+    glm::vec2 m = center - corner;
+    float a = glm::dot(motion, motion), b = glm::dot(m, motion), c = glm::dot(m, m) - radius * radius;
+    float discriminant = b * b - a * c;
+    if (discriminant < 0.0f)
+        return false;
+    float t = (-b - std::sqrt(discriminant)) / a;
+    if (t < 0.0f || t > 1.0f)
+        return false;
+    hit.Time = t;
+    hit.Normal = glm::normalize(center + motion * t - corner);
+    return true;
+}
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef TEXT_RENDERER_H
+#define TEXT_RENDERER_H
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "texture.h"
+#include "shader.h"
+#include "SpriteRenderer.h"
+#include "StreamBuffer.h"
+
+// maximum number of glyphs queued per frame
+const unsigned int MAX_TEXT_GLYPHS = 4096;
+
+// state information relevant to a character as rasterized from the font
+struct Character {
+    glm::vec2 Size;      // size of glyph
+    glm::vec2 Bearing;   // offset from baseline to left/top of glyph
+    float     Advance;   // horizontal offset to advance to next glyph
+    glm::vec2 UVOrigin;  // region of the glyph in the atlas
+    glm::vec2 UVSize;
+};
+
+// a string laid out relative to its top-left corner, one quad per visible glyph
+struct TextLayout {
+    std::vector<glm::vec4> Quads;  // position, size
+    std::vector<glm::vec4> UVs;    // uv origin, uv size
+    float Width;
+};
+
+// TextRenderer renders text with a TrueType font rasterized once into a
+// single-channel glyph atlas. Laid out strings are cached, RenderText only
+// queues their quads and Flush draws all text queued in a frame with a
+// single draw call.
+class TextRenderer
+{
+public:
+    // holds a list of pre-compiled Characters
+    std::map<char, Character> Characters;
+    // shader used for text rendering
+    Shader TextShader;
+    // all glyphs, one channel
+    Texture2D Atlas;
+    // statistics
+    unsigned int DrawCalls;
+    // constructor/destructor
+    TextRenderer(Shader shader);
+    ~TextRenderer();
+    // pre-compiles the printable ASCII characters of the given font; pixelScale > 1 rasterizes
+    // them sharper for high DPI framebuffers while the metrics stay in board units
+    void Load(std::string font, unsigned int fontSize, float pixelScale = 1.0f);
+    // queues a string with its top-left corner at (x, y); text that changes every few frames
+    // (timings, counters) should pass cache = false so it doesn't push the lasting strings out
+    void RenderText(const std::string &text, float x, float y, float scale, glm::vec3 color = glm::vec3(1.0f), bool cache = true);
+    // width of a string, e.g. to center it
+    float TextWidth(const std::string &text, float scale);
+    // draws all queued text; call once at the end of every frame
+    void Flush();
+
+    void ResetStats();
+private:
+    // render state
+    unsigned int VAO;
+    StreamBuffer *stream;
+    std::vector<SpriteVertex> vertices;
+    // distance from the top of a line to the baseline
+    float ascent;
+    // laid out strings, keyed by text and scale
+    std::unordered_map<std::string, TextLayout> layouts;
+    // layout of the last uncached string, reused to keep its storage
+    TextLayout scratch;
+    // returns the cached layout of a string, laying it out on first use
+    const TextLayout &layout(const std::string &text, float scale);
+    // lays out a string into the given layout
+    void layOut(const std::string &text, float scale, TextLayout &layout);
+};
+
+#endif
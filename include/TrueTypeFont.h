@@ -0,0 +1,52 @@
+#ifndef TRUETYPE_FONT_H
+#define TRUETYPE_FONT_H
+
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// a rasterized glyph; one coverage byte per pixel, rows top to bottom
+struct GlyphBitmap {
+    int Width, Height;
+    int Left, Top;      // offset from the pen position to the top-left pixel, y up
+    float Advance;      // horizontal offset to the next glyph, in pixels
+    std::vector<unsigned char> Pixels;
+};
+
+// A TrueType font file read just far enough to rasterize its glyphs: the
+// character map (format 4), the horizontal metrics and the quadratic glyf
+// outlines, composite glyphs included. Outlines are flattened into lines and
+// filled with exact per-pixel area coverage. There is no hinting, so glyphs
+// are slightly softer than a hinting rasterizer's, which doesn't matter for
+// the few sizes the game's text uses.
+class TrueTypeFont
+{
+public:
+    // constructor
+    TrueTypeFont();
+    // reads a font file; returns false (and prints the error) if it can't be used
+    bool Load(const std::string &file);
+    // scale from font units to pixels for an em of the given height in pixels
+    float ScaleForPixelHeight(float pixels) const;
+    // rasterizes the glyph of a character; characters the font lacks get its missing glyph
+    void RenderGlyph(unsigned int codepoint, float scale, GlyphBitmap &bitmap) const;
+private:
+    std::vector<unsigned char> data;
+    // offsets of the tables used
+    unsigned int cmap, glyf, loca, hmtx;
+    unsigned int unitsPerEm, glyphCount, horizontalMetrics;
+    bool longOffsets;
+    // big-endian reads
+    unsigned int u16(unsigned int offset) const;
+    int s16(unsigned int offset) const;
+    unsigned int u32(unsigned int offset) const;
+    // offset of a table, 0 if the font has none
+    unsigned int table(const char *tag) const;
+    // glyph index of a character, 0 (the missing glyph) if it isn't mapped
+    unsigned int glyphIndex(unsigned int codepoint) const;
+    // appends the glyph's contours, flattened to polylines in pixels (y up), transformed by the 2x2 matrix and offset
+    void outline(unsigned int glyph, const glm::mat2 &matrix, glm::vec2 offset, std::vector< std::vector<glm::vec2> > &contours, int depth) const;
+};
+
+#endif
@@ -6,7 +6,7 @@
 
 #include "GameLevel.h"
 #include "ball.h"
-#include "ParticleGenerator.h"
+#include "ParticleSystem.h"
 #include "PostProcessor.h"
 #include "PowerUp.h"
 
@@ -36,6 +36,15 @@ const glm::vec2 INITIAL_BALL_VELOCITY(100.0f, -350.0f);
 // Radius of the ball object
 const float BALL_RADIUS = 12.5f;
 
+// Most contacts the continuous ball sweep resolves in one step; the rest of the motion is dropped
+const unsigned int MAX_BALL_BOUNCES = 16;
+
+// Distance the swept ball is kept from a surface it touched
+const float BALL_CONTACT_GAP = 0.01f;
+
+// Maximum number of live particles shared by all emitters
+const unsigned int PARTICLE_BUDGET = 1000;
+
 // Defines a Collision typedef that represents collision data
 // a tuple to store: whether collide, collide direction, R vector
 typedef std::tuple<bool, Direction, glm::vec2> Collision; 
@@ -49,6 +58,7 @@ class Game
         bool Keys[1024]; // user input
         bool KeysProcessed[1024];
         unsigned int Width, Height; // game board size
+        unsigned int FramebufferWidth, FramebufferHeight; // drawable size in pixels (larger than Width/Height on high DPI screens)
 
         std::vector<GameLevel> Levels;
         unsigned int           Level;
@@ -56,6 +66,10 @@ class Game
         std::vector<PowerUp>    PowerUps;
 
         unsigned int Lives;
+        unsigned int Score;
+
+        // sweep the ball through each step instead of testing overlaps at its new position
+        bool ContinuousCollisions;
 
         // constructor & deconstructor
         Game(unsigned int width, unsigned int height);
@@ -64,15 +78,33 @@ class Game
         void Init();
         void ProcessInput(float dt);
         void Update(float dt);
-        void Render();
-        void DoCollisions();
+        // alpha is how far the current frame is between the last two simulation ticks
+        void Render(float alpha = 1.0f);
+        // remembers the moving objects' positions at the start of a simulation tick
+        void SavePositions();
+        // records the counters of the frame just finished for the performance overlay (toggled with F3)
+        void RecordFrame();
+        // the framebuffer changed size (DPI change, window resize); render targets are reallocated to match
+        void Resize(unsigned int framebufferWidth, unsigned int framebufferHeight);
+        // ballStart is where the ball was before this step's move
+        void DoCollisions(glm::vec2 ballStart);
+        // moves the ball by dt, bouncing off bricks, the paddle and the walls at their times of impact
+        void SweepBall(float dt);
+        // catches the power-ups that reached the paddle
+        void DoPowerUpCollisions();
+        // destroys a brick the ball hit, or shakes the screen for a solid one
+        void HitBrick(unsigned int index);
         
+        // redraws the cached background and solid bricks of the current level
+        void BuildStaticLayer();
+
         // reset
         void ResetLevel();
         void ResetPlayer();
 
         // powerups
-        void SpawnPowerUps(GameObject &block);
+        // rolls for power-ups dropping from a destroyed brick at position
+        void SpawnPowerUps(glm::vec2 position);
         void UpdatePowerUps(float dt);
 };
 
@@ -3,6 +3,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include <glad/glad.h>
 
@@ -21,8 +22,11 @@ public:
     // resource storage
     static std::map<std::string, Shader>    Shaders;
     static std::map<std::string, Texture2D> Textures;
+    static std::map<std::string, SubTexture> SubTextures;
     // loads (and generates) a shader program from file loading vertex, fragment (and geometry) shader's source code. If gShaderFile is not nullptr, it also loads a geometry shader
     static Shader LoadShader(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile, std::string name);
+    // loads (and generates) a vertex-only transform feedback program capturing the given outputs
+    static Shader LoadFeedbackShader(const char *vShaderFile, std::vector<std::string> varyings, std::string name);
 
     // retrieves a stored sader
     static Shader GetShader(std::string name);
@@ -33,6 +37,15 @@ public:
     // retrieves a stored texture
     static Texture2D GetTexture(std::string name);
 
+    // packs a group of already loaded textures into one atlas texture stored under name; each member then resolves to its region through GetSubTexture
+    static Texture2D PackAtlas(std::vector<std::string> members, std::string name, unsigned int padding = 2);
+
+    // retrieves a texture region; a texture that is not part of an atlas is returned whole
+    static SubTexture GetSubTexture(std::string name);
+
+    // estimated bytes of all stored textures
+    static size_t TextureMemory();
+
     // properly de-allocates all loaded resources
     static void  Clear();
 private:
@@ -9,7 +9,9 @@
 #ifndef SHADER_H
 #define SHADER_H
 
+#include <map>
 #include <string>
+#include <vector>
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
@@ -20,13 +22,30 @@ class Shader
 public:
     // state
     unsigned int ID; 
+    // locations of all active uniforms, filled once the program is linked
+    std::map<std::string, int> Uniforms;
     // constructor
     Shader() { }
     // sets the current shader as active
     Shader  &Use();
     // compiles the shader from given source code
     void    Compile(const char *vertexSource, const char *fragmentSource, const char *geometrySource = nullptr); // note: geometry source code is optional 
-    // utility functions
+    // compiles a vertex-only program whose outputs are captured interleaved, in the given order, with transform feedback
+    void    CompileFeedback(const char *vertexSource, const std::vector<std::string> &varyings);
+    // assigns the named uniform block to a uniform buffer binding point
+    void    BindUniformBlock(const char *name, unsigned int binding);
+    // returns the cached location of a uniform (-1 if the program has no such active uniform)
+    int     GetUniformLocation(const char *name) const;
+    // utility functions; the name based setters go through the location cache, hot paths should keep the location instead
+    void    SetFloat    (int location, float value, bool useShader = false);
+    void    SetInteger  (int location, int value, bool useShader = false);
+    void    SetVector2f (int location, float x, float y, bool useShader = false);
+    void    SetVector2f (int location, const glm::vec2 &value, bool useShader = false);
+    void    SetVector3f (int location, float x, float y, float z, bool useShader = false);
+    void    SetVector3f (int location, const glm::vec3 &value, bool useShader = false);
+    void    SetVector4f (int location, float x, float y, float z, float w, bool useShader = false);
+    void    SetVector4f (int location, const glm::vec4 &value, bool useShader = false);
+    void    SetMatrix4  (int location, const glm::mat4 &matrix, bool useShader = false);
     void    SetFloat    (const char *name, float value, bool useShader = false);
     void    SetInteger  (const char *name, int value, bool useShader = false);
     void    SetVector2f (const char *name, float x, float y, bool useShader = false);
@@ -39,6 +58,8 @@ public:
 private:
     // checks if compilation or linking failed and if so, print the error logs
     void    checkCompileErrors(unsigned int object, std::string type); 
+    // queries all active uniforms of the linked program and stores their locations
+    void    cacheUniformLocations();
 };
 
 #endif
\ No newline at end of file
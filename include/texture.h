@@ -10,6 +10,7 @@
 #define TEXTURE_H
 
 #include <glad/glad.h>
+#include <glm/glm.hpp>
 
 // Texture2D is able to store and configure a texture in OpenGL.
 // It also hosts utility functions for easy management.
@@ -36,4 +37,17 @@ public:
     void Bind() const;
 };
 
+// SubTexture references a rectangle of a Texture2D in normalized texture
+// coordinates, e.g. one image packed into an atlas. A plain Texture2D
+// converts to a SubTexture covering the whole texture.
+class SubTexture
+{
+public:
+    Texture2D Texture;
+    glm::vec2 UVOrigin, UVSize;
+    // constructors (default covers the whole texture)
+    SubTexture();
+    SubTexture(const Texture2D &texture, glm::vec2 uvOrigin = glm::vec2(0.0f), glm::vec2 uvSize = glm::vec2(1.0f));
+};
+
 #endif
\ No newline at end of file
@@ -0,0 +1,10 @@
+#version 330 core
+layout (location = 0) in vec4 vertex; // <vec2 position, vec2 texCoords> in NDC
+
+out vec2 TexCoords;
+
+void main()
+{
+    gl_Position = vec4(vertex.xy, 0.0, 1.0);
+    TexCoords = vertex.zw;
+}
@@ -0,0 +1,28 @@
+#version 330 core
+layout (location = 0) in vec4 vertex;   // <vec2 position, vec2 texCoords> of the unit quad
+layout (location = 1) in vec4 rect;     // per brick: <vec2 position, vec2 size>
+layout (location = 2) in vec4 color;    // per brick: alpha 0 marks a destroyed brick
+layout (location = 3) in vec4 texRect;  // per brick: <vec2 uv origin, vec2 uv size>
+
+out vec2 TexCoords;
+out vec4 SpriteColor;
+
+layout (std140) uniform Frame
+{
+    mat4  projection;
+    vec4  viewport;   // width, height, 1/width, 1/height
+    float time;
+    bool  chaos;
+    bool  confuse;
+    bool  shake;
+};
+
+void main()
+{
+    TexCoords = texRect.xy + vertex.zw * texRect.zw;
+    SpriteColor = color;
+    if (color.a == 0.0)
+        gl_Position = vec4(0.0, 0.0, 0.0, 0.0); // collapse destroyed bricks so they cost no fill
+    else
+        gl_Position = projection * vec4(rect.xy + vertex.xy * rect.zw, 0.0, 1.0);
+}
@@ -1,12 +1,20 @@
 #version 330 core
 layout (location = 0) in vec4 vertex; // <vec2 position, vec2 texCoords>
+layout (location = 1) in vec2 offset; // per particle
+layout (location = 2) in vec4 color;  // per particle
 
 out vec2 TexCoords;
 out vec4 ParticleColor;
 
-uniform mat4 projection;
-uniform vec2 offset;
-uniform vec4 color;
+layout (std140) uniform Frame
+{
+    mat4  projection;
+    vec4  viewport;   // width, height, 1/width, 1/height
+    float time;
+    bool  chaos;
+    bool  confuse;
+    bool  shake;
+};
 
 void main()
 {
@@ -14,4 +22,7 @@ void main()
     TexCoords = vertex.zw;
     ParticleColor = color;
     gl_Position = projection * vec4((vertex.xy * scale) + offset, 0.0, 1.0);
-}
\ No newline at end of file
+    // dead slots of the GPU particle buffer are zeroed, collapse them
+    if (color == vec4(0.0))
+        gl_Position = vec4(0.0);
+}
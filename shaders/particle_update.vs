@@ -0,0 +1,31 @@
+#version 330 core
+layout (location = 0) in vec2 position;
+layout (location = 1) in vec2 velocity;
+layout (location = 2) in vec4 color;
+layout (location = 3) in float life;
+
+// captured with transform feedback into the other particle buffer
+out vec2 outPosition;
+out vec2 outVelocity;
+out vec4 outColor;
+out float outLife;
+
+uniform float dt;
+uniform float fadeRate;
+
+void main()
+{
+    outVelocity = velocity;
+    outLife = life - dt;
+    if (outLife > 0.0)
+    {
+        outPosition = position - velocity * dt;
+        outColor = vec4(color.rgb, color.a - dt * fadeRate);
+    }
+    else
+    {
+        // dead particles keep a zero color so particle.vs can collapse them
+        outPosition = position;
+        outColor = vec4(0.0);
+    }
+}
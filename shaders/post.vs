@@ -0,0 +1,26 @@
+#version 330 core
+layout (location = 0) in vec4 vertex; // <vec2 position, vec2 texCoords> in NDC
+
+out vec2 TexCoords;
+
+// per pass texture coordinate transform and animation (0 disables)
+uniform vec2  uvScale;
+uniform vec2  uvOffset;
+uniform float swirl;
+uniform float jitter;
+
+layout (std140) uniform Frame
+{
+    mat4  projection;
+    vec4  viewport;   // width, height, 1/width, 1/height
+    float time;
+    bool  chaos;
+    bool  confuse;
+    bool  shake;
+};
+
+void main()
+{
+    gl_Position = vec4(vertex.xy + jitter * vec2(cos(time * 10), cos(time * 15)), 0.0, 1.0);
+    TexCoords = uvOffset + uvScale * vertex.zw + swirl * vec2(sin(time), cos(time));
+}
@@ -0,0 +1,24 @@
+#version 330 core
+in  vec2 TexCoords;
+out vec4 color;
+
+// one direction of a separable blur
+uniform sampler2D scene;
+uniform vec2      texel;       // step between taps, along the blur direction
+uniform int       radius;
+uniform float     weights[17]; // center tap first
+uniform vec2      region;      // part of the texture holding the image
+
+// the image repeats like a GL_REPEAT texture even when it only fills region
+vec3 scenePixel(vec2 uv)
+{
+    return texture(scene, fract(uv) * region).rgb;
+}
+
+void main()
+{
+    vec3 sum = scenePixel(TexCoords) * weights[0];
+    for (int i = 1; i <= radius; i++)
+        sum += (scenePixel(TexCoords + texel * i) + scenePixel(TexCoords - texel * i)) * weights[i];
+    color = vec4(sum, 1.0);
+}
@@ -0,0 +1,17 @@
+#version 330 core
+in  vec2 TexCoords;
+out vec4 color;
+
+uniform sampler2D scene;
+uniform vec2      region;      // part of the texture holding the image
+
+// the image repeats like a GL_REPEAT texture even when it only fills region
+vec3 scenePixel(vec2 uv)
+{
+    return texture(scene, fract(uv) * region).rgb;
+}
+
+void main()
+{
+    color = vec4(scenePixel(TexCoords), 1.0);
+}
@@ -0,0 +1,24 @@
+#version 330 core
+in  vec2 TexCoords;
+out vec4 color;
+
+uniform sampler2D scene;
+uniform vec2      texel;       // step between taps
+uniform vec2      region;      // part of the texture holding the image
+
+// the image repeats like a GL_REPEAT texture even when it only fills region
+vec3 scenePixel(vec2 uv)
+{
+    return texture(scene, fract(uv) * region).rgb;
+}
+
+void main()
+{
+    // 3x3 edge kernel: 8 * center - neighbours
+    vec3 sum = vec3(0.0);
+    for (int y = -1; y <= 1; y++)
+        for (int x = -1; x <= 1; x++)
+            sum -= scenePixel(TexCoords + texel * vec2(x, y));
+    sum += 9.0 * scenePixel(TexCoords);
+    color = vec4(sum, 1.0);
+}
@@ -1,13 +1,23 @@
 #version 330 core
-layout (location = 0) in vec4 vertex; // <vec2 position, vec2 texCoords>
+layout (location = 0) in vec4 vertex; // <vec2 position, vec2 texCoords>, already in world space
+layout (location = 1) in vec4 color;
 
 out vec2 TexCoords;
+out vec4 SpriteColor;
 
-uniform mat4 model;
-uniform mat4 projection;
+layout (std140) uniform Frame
+{
+    mat4  projection;
+    vec4  viewport;   // width, height, 1/width, 1/height
+    float time;
+    bool  chaos;
+    bool  confuse;
+    bool  shake;
+};
 
 void main()
 {
     TexCoords = vertex.zw;
-    gl_Position = projection * model * vec4(vertex.xy, 0.0, 1.0);
+    SpriteColor = color;
+    gl_Position = projection * vec4(vertex.xy, 0.0, 1.0);
 }
@@ -0,0 +1,36 @@
+#include "FrameUniforms.h"
+
+FrameUniforms::FrameUniforms()
+    : Data()
+{
+    this->Data.Projection = glm::mat4(1.0f);
+    glGenBuffers(1, &this->UBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, this->UBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameData), &this->Data, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    // the buffer stays bound to its binding point for the lifetime of the game
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_UNIFORM_BINDING, this->UBO);
+}
+
+FrameUniforms::~FrameUniforms()
+{
+    glDeleteBuffers(1, &this->UBO);
+}
+
+void FrameUniforms::Attach(Shader &shader)
+{
+    shader.BindUniformBlock("Frame", FRAME_UNIFORM_BINDING);
+}
+
+void FrameUniforms::SetView(const glm::mat4 &projection, unsigned int width, unsigned int height)
+{
+    this->Data.Projection = projection;
+    this->Data.Viewport = glm::vec4(width, height, 1.0f / width, 1.0f / height);
+}
+
+void FrameUniforms::Upload()
+{
+    glBindBuffer(GL_UNIFORM_BUFFER, this->UBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameData), &this->Data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
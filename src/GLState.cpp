@@ -0,0 +1,113 @@
+#include "GLState.h"
+
+// Instantiate static variables
+unsigned int GLState::Issued = 0;
+unsigned int GLState::Skipped = 0;
+unsigned int GLState::program = ~0u;
+unsigned int GLState::activeUnit = ~0u;
+unsigned int GLState::textures[MAX_TRACKED_TEXTURE_UNITS] = { ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u };
+unsigned int GLState::vertexArray = ~0u;
+unsigned int GLState::blendSrc = ~0u;
+unsigned int GLState::blendDst = ~0u;
+
+void GLState::UseProgram(unsigned int program)
+{
+    if (GLState::program == program)
+    {
+        Skipped++;
+        return;
+    }
+    glUseProgram(program);
+    GLState::program = program;
+    Issued++;
+}
+
+void GLState::ActiveTexture(unsigned int unit)
+{
+    if (activeUnit == unit)
+    {
+        Skipped++;
+        return;
+    }
+    glActiveTexture(unit);
+    activeUnit = unit;
+    Issued++;
+}
+
+void GLState::BindTexture(unsigned int texture)
+{
+    unsigned int index = activeUnit - GL_TEXTURE0;
+    // untracked (or unknown) unit: always forward
+    if (index >= MAX_TRACKED_TEXTURE_UNITS)
+    {
+        glBindTexture(GL_TEXTURE_2D, texture);
+        Issued++;
+        return;
+    }
+    if (textures[index] == texture)
+    {
+        Skipped++;
+        return;
+    }
+    glBindTexture(GL_TEXTURE_2D, texture);
+    textures[index] = texture;
+    Issued++;
+}
+
+void GLState::DeleteTexture(unsigned int texture)
+{
+    glDeleteTextures(1, &texture);
+    // the name may be handed out again by glGenTextures, a stale binding would then skip binding the new texture
+    for (unsigned int i = 0; i < MAX_TRACKED_TEXTURE_UNITS; ++i)
+        if (textures[i] == texture)
+            textures[i] = 0;
+}
+
+void GLState::BindVertexArray(unsigned int vertexArray)
+{
+    if (GLState::vertexArray == vertexArray)
+    {
+        Skipped++;
+        return;
+    }
+    glBindVertexArray(vertexArray);
+    GLState::vertexArray = vertexArray;
+    Issued++;
+}
+
+void GLState::DeleteVertexArray(unsigned int vertexArray)
+{
+    glDeleteVertexArrays(1, &vertexArray);
+    // like textures, a stale binding to a reused name would skip binding the new vertex array
+    if (GLState::vertexArray == vertexArray)
+        GLState::vertexArray = 0;
+}
+
+void GLState::BlendFunc(unsigned int sfactor, unsigned int dfactor)
+{
+    if (blendSrc == sfactor && blendDst == dfactor)
+    {
+        Skipped++;
+        return;
+    }
+    glBlendFunc(sfactor, dfactor);
+    blendSrc = sfactor;
+    blendDst = dfactor;
+    Issued++;
+}
+
+void GLState::Invalidate()
+{
+    program = ~0u;
+    activeUnit = ~0u;
+    for (unsigned int i = 0; i < MAX_TRACKED_TEXTURE_UNITS; ++i)
+        textures[i] = ~0u;
+    vertexArray = ~0u;
+    blendSrc = blendDst = ~0u;
+}
+
+void GLState::ResetFrameCounters()
+{
+    Issued = 0;
+    Skipped = 0;
+}
@@ -1,16 +1,62 @@
 #include "GameLevel.h"
+#include "GLState.h"
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <sstream>
+#include <utility>
 
-GameLevel::GameLevel(){}
+GameLevel::GameLevel() : DrawCalls(0), bricksLeft(0), VAO(0), quadVBO(0), instanceVBO(0), dirtyBegin(0), dirtyEnd(0), columns(0), rows(0), cellSize(0.0f) {}
+
+GameLevel::~GameLevel() {
+    this->releaseRenderData();
+}
+
+GameLevel::GameLevel(GameLevel &&other) : GameLevel() {
+    *this = std::move(other);
+}
+
+GameLevel &GameLevel::operator=(GameLevel &&other) {
+    if (this == &other)
+        return *this;
+    this->releaseRenderData();
+    this->DrawCalls = other.DrawCalls;
+    this->column = std::move(other.column);
+    this->row = std::move(other.row);
+    this->style = std::move(other.style);
+    this->destroyed = std::move(other.destroyed);
+    this->bricksLeft = other.bricksLeft;
+    this->styles = std::move(other.styles);
+    this->shader = other.shader;
+    // the GL objects change owner, the moved-from level must not delete them
+    this->VAO = other.VAO;
+    this->quadVBO = other.quadVBO;
+    this->instanceVBO = other.instanceVBO;
+    other.VAO = other.quadVBO = other.instanceVBO = 0;
+    this->slots = std::move(other.slots);
+    this->slotBricks = std::move(other.slotBricks);
+    this->batches = std::move(other.batches);
+    this->dirtyBegin = other.dirtyBegin;
+    this->dirtyEnd = other.dirtyEnd;
+    this->cells = std::move(other.cells);
+    this->columns = other.columns;
+    this->rows = other.rows;
+    this->cellSize = other.cellSize;
+    return *this;
+}
 
 void GameLevel::Load(const char *file, unsigned int levelWidth, unsigned int levelHeight) {
     // clear old data
-    this->Bricks.clear();
+    this->column.clear();
+    this->row.clear();
+    this->style.clear();
+    this->destroyed.clear();
+    this->bricksLeft = 0;
+    this->cells.clear();
+    this->columns = this->rows = 0;
 
     // load from file
     unsigned int tileCode;
-    GameLevel level;
 
     std::string line;
     std::ifstream fstream(file);
@@ -28,6 +74,7 @@ void GameLevel::Load(const char *file, unsigned int levelWidth, unsigned int lev
         if (tileData.size() > 0)
             this->init(tileData, levelWidth, levelHeight);
     }
+    this->initRenderData();
 }
 
 
@@ -37,51 +84,249 @@ void GameLevel::init(std::vector< std::vector<unsigned int> > tileData, unsigned
     // note we can index vector at [0] since this function is only called if height > 0
     unsigned int width = tileData[0].size(); 
     float unit_width = levelWidth / static_cast<float>(width), unit_height = levelHeight / height; 
+    // the bricks sit on a regular grid, so a cell index is all the broadphase needs
+    this->columns = width;
+    this->rows = height;
+    this->cellSize = glm::vec2(unit_width, unit_height);
+    this->cells.assign(width * height, -1);
+
+    // one style per tile code: 1 is solid, 2 to 5 are colored, anything higher is white
+    SubTexture block = ResourceManager::GetSubTexture("block");
+    this->styles = {
+        { glm::vec3(0.8f, 0.8f, 0.7f), ResourceManager::GetSubTexture("block_solid"), true },
+        { glm::vec3(0.969f, 0.792f, 0.788f), block, false },
+        { glm::vec3(0.973f, 0.514f, 0.475f), block, false },
+        { glm::vec3(1.0f, 0.0f, 0.14f), block, false },
+        { glm::vec3(0.89f, 0.259f, 0.204f), block, false },
+        { glm::vec3(1.0f), block, false }
+    };
 
     // initialize level tiles based on tileData		
     for (unsigned int y = 0; y < height; ++y)
     {
-        for (unsigned int x = 0; x < width; ++x)
+        for (unsigned int x = 0; x < width && x < tileData[y].size(); ++x)
         {
-            // check block type from level data (2D level array)
-            if (tileData[y][x] == 1) // solid
-            {
-                glm::vec2 pos(unit_width * x, unit_height * y);
-                glm::vec2 size(unit_width, unit_height);
-                GameObject obj(pos, size, ResourceManager::GetTexture("block_solid"), glm::vec3(0.8f, 0.8f, 0.7f));
-                obj.IsSolid = true;
-                this->Bricks.push_back(obj);
-            }
-            else if (tileData[y][x] > 1)	// non-solid; now determine its color based on level data
-            {
-                glm::vec3 color = glm::vec3(1.0f); // original: white
-                if (tileData[y][x] == 2)
-                    color = glm::vec3(0.969f, 0.792f, 0.788f);
-                else if (tileData[y][x] == 3)
-                    color = glm::vec3(0.973f, 0.514f, 0.475f);
-                else if (tileData[y][x] == 4)
-                    color = glm::vec3(1.0f, 0.0f, 0.14f);
-                else if (tileData[y][x] == 5)
-                    color = glm::vec3(0.89f, 0.259f, 0.204f);
-
-                glm::vec2 pos(unit_width * x, unit_height * y);
-                glm::vec2 size(unit_width, unit_height);
-                this->Bricks.push_back(GameObject(pos, size, ResourceManager::GetTexture("block"), color));
-            }
+            unsigned int code = tileData[y][x];
+            if (code == 0)
+                continue;
+            this->cells[y * width + x] = this->column.size();
+            this->column.push_back(x);
+            this->row.push_back(y);
+            this->style.push_back(std::min(code, 6u) - 1);
+            if (code > 1)
+                this->bricksLeft++;
         }
     }
+    this->destroyed.assign((this->column.size() + 63) / 64, 0);
 }
 
 void GameLevel::Draw(SpriteRenderer &renderer) {
-    for (GameObject &tile : this->Bricks)
-        if (!tile.Destroyed)
-            tile.Draw(renderer);
+    this->drawBatches(renderer, false);
+}
+
+void GameLevel::DrawStatic(SpriteRenderer &renderer) {
+    this->drawBatches(renderer, true);
+}
+
+void GameLevel::drawBatches(SpriteRenderer &renderer, bool solid) {
+    // anything already batched (e.g. the background) has to land underneath the bricks
+    renderer.Flush();
+    if (this->slotBricks.empty())
+        return;
+
+    // upload only the slots touched since the last frame, rebuilt from the brick data
+    if (this->dirtyBegin < this->dirtyEnd)
+    {
+        std::vector<BrickInstance> dirty;
+        dirty.reserve(this->dirtyEnd - this->dirtyBegin);
+        for (unsigned int slot = this->dirtyBegin; slot < this->dirtyEnd; ++slot)
+            dirty.push_back(this->instance(this->slotBricks[slot]));
+        glBindBuffer(GL_ARRAY_BUFFER, this->instanceVBO);
+        glBufferSubData(GL_ARRAY_BUFFER, this->dirtyBegin * sizeof(BrickInstance), dirty.size() * sizeof(BrickInstance), dirty.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        this->dirtyBegin = this->dirtyEnd = 0;
+    }
+
+    this->shader.Use();
+    GLState::ActiveTexture(GL_TEXTURE0);
+    GLState::BindVertexArray(this->VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, this->instanceVBO);
+    for (BrickBatch &batch : this->batches)
+    {
+        if (batch.Solid != solid)
+            continue;
+        // GL 3.3 has no base instance, so point the per-instance attributes at the batch's first slot
+        size_t base = batch.First * sizeof(BrickInstance);
+        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(BrickInstance), (void*)(base + offsetof(BrickInstance, Rect)));
+        glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(BrickInstance), (void*)(base + offsetof(BrickInstance, Color)));
+        glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(BrickInstance), (void*)(base + offsetof(BrickInstance, TexRect)));
+        GLState::BindTexture(batch.Texture);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 6, batch.Count);
+        this->DrawCalls++;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void GameLevel::DestroyBrick(unsigned int index) {
+    if (this->IsDestroyed(index))
+        return;
+    this->destroyed[index / 64] |= uint64_t(1) << (index % 64);
+    if (!this->IsSolid(index))
+        this->bricksLeft--;
+
+    // the brick's instance is hidden with the next upload; grow the dirty range to cover it
+    unsigned int slot = this->slots[index];
+    if (this->dirtyBegin == this->dirtyEnd)
+    {
+        this->dirtyBegin = slot;
+        this->dirtyEnd = slot + 1;
+    }
+    else
+    {
+        this->dirtyBegin = std::min(this->dirtyBegin, slot);
+        this->dirtyEnd = std::max(this->dirtyEnd, slot + 1);
+    }
+}
+
+unsigned int GameLevel::BrickCount() const {
+    return this->column.size();
+}
+
+unsigned int GameLevel::BricksLeft() const {
+    return this->bricksLeft;
+}
+
+glm::vec2 GameLevel::BrickPosition(unsigned int index) const {
+    return glm::vec2(this->column[index], this->row[index]) * this->cellSize;
+}
+
+glm::vec2 GameLevel::BrickSize() const {
+    return this->cellSize;
 }
 
-bool GameLevel::IsCompleted() {
-    for (GameObject &tile : this->Bricks)
-        if (!tile.IsSolid && !tile.Destroyed)
-            return false;
-    return true;
+glm::vec3 GameLevel::BrickColor(unsigned int index) const {
+    return this->styles[this->style[index]].Color;
 }
 
+bool GameLevel::IsSolid(unsigned int index) const {
+    return this->styles[this->style[index]].Solid;
+}
+
+bool GameLevel::IsDestroyed(unsigned int index) const {
+    return (this->destroyed[index / 64] >> (index % 64)) & 1;
+}
+
+void GameLevel::Query(glm::vec2 min, glm::vec2 max, std::vector<unsigned int> &bricks) const {
+    bricks.clear();
+    if (this->cells.empty())
+        return;
+    // cells touched by the box, clamped to the grid
+    int x0 = std::max(0, static_cast<int>(std::floor(min.x / this->cellSize.x)));
+    int y0 = std::max(0, static_cast<int>(std::floor(min.y / this->cellSize.y)));
+    int x1 = std::min(static_cast<int>(this->columns) - 1, static_cast<int>(std::floor(max.x / this->cellSize.x)));
+    int y1 = std::min(static_cast<int>(this->rows) - 1, static_cast<int>(std::floor(max.y / this->cellSize.y)));
+    // bricks were added row by row, so walking the cells the same way keeps them in index order
+    for (int y = y0; y <= y1; ++y)
+        for (int x = x0; x <= x1; ++x)
+        {
+            int brick = this->cells[y * this->columns + x];
+            if (brick >= 0)
+                bricks.push_back(brick);
+        }
+}
+
+void GameLevel::ResetStats() {
+    this->DrawCalls = 0;
+}
+
+bool GameLevel::IsCompleted() const {
+    return this->bricksLeft == 0;
+}
+
+void GameLevel::releaseRenderData() {
+    if (this->VAO == 0)
+        return;
+    GLState::DeleteVertexArray(this->VAO);
+    glDeleteBuffers(1, &this->quadVBO);
+    glDeleteBuffers(1, &this->instanceVBO);
+    this->VAO = this->quadVBO = this->instanceVBO = 0;
+}
+
+void GameLevel::initRenderData() {
+    if (this->VAO == 0)
+    {
+        float vertices[] = {
+            // pos      // tex
+            0.0f, 1.0f, 0.0f, 1.0f,
+            1.0f, 0.0f, 1.0f, 0.0f,
+            0.0f, 0.0f, 0.0f, 0.0f,
+
+            0.0f, 1.0f, 0.0f, 1.0f,
+            1.0f, 1.0f, 1.0f, 1.0f,
+            1.0f, 0.0f, 1.0f, 0.0f
+        };
+        glGenVertexArrays(1, &this->VAO);
+        glGenBuffers(1, &this->quadVBO);
+        glGenBuffers(1, &this->instanceVBO);
+
+        GLState::BindVertexArray(this->VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, this->quadVBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+
+        // per-instance attributes; their offsets are set per batch in Draw
+        glBindBuffer(GL_ARRAY_BUFFER, this->instanceVBO);
+        for (unsigned int i = 1; i <= 3; ++i)
+        {
+            glEnableVertexAttribArray(i);
+            glVertexAttribDivisor(i, 1);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        GLState::BindVertexArray(0);
+
+        this->shader = ResourceManager::GetShader("brick");
+    }
+
+    // order the bricks by solidity and texture so every combination becomes one contiguous batch
+    unsigned int count = this->BrickCount();
+    this->slotBricks.resize(count);
+    for (unsigned int i = 0; i < count; ++i)
+        this->slotBricks[i] = i;
+    std::stable_sort(this->slotBricks.begin(), this->slotBricks.end(), [this](unsigned int a, unsigned int b) {
+        const BrickStyle &one = this->styles[this->style[a]], &two = this->styles[this->style[b]];
+        if (one.Solid != two.Solid)
+            return one.Solid;
+        return one.Sprite.Texture.ID < two.Sprite.Texture.ID;
+    });
+
+    std::vector<BrickInstance> instances;
+    instances.reserve(count);
+    this->batches.clear();
+    this->slots.assign(count, 0);
+    for (unsigned int index : this->slotBricks)
+    {
+        const BrickStyle &tile = this->styles[this->style[index]];
+        if (this->batches.empty() || this->batches.back().Texture != tile.Sprite.Texture.ID || this->batches.back().Solid != tile.Solid)
+            this->batches.push_back({ tile.Sprite.Texture.ID, tile.Solid, (unsigned int)instances.size(), 0 });
+        this->batches.back().Count++;
+
+        this->slots[index] = instances.size();
+        instances.push_back(this->instance(index));
+    }
+
+    // the whole buffer is only uploaded here; destroying bricks patches single slots
+    glBindBuffer(GL_ARRAY_BUFFER, this->instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(BrickInstance), instances.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    this->dirtyBegin = this->dirtyEnd = 0;
+}
+
+BrickInstance GameLevel::instance(unsigned int index) const {
+    const BrickStyle &tile = this->styles[this->style[index]];
+    return {
+        glm::vec4(this->BrickPosition(index), this->cellSize),
+        glm::vec4(tile.Color, this->IsDestroyed(index) ? 0.0f : 1.0f),
+        glm::vec4(tile.Sprite.UVOrigin, tile.Sprite.UVSize)
+    };
+}
@@ -1,14 +1,20 @@
 #include "GameObject.h"
 
 GameObject::GameObject() 
-: Position(0.0f, 0.0f), Size(1.0f, 1.0f), Velocity(0.0f), Color(1.0f), Rotation(0.0f), Sprite(), IsSolid(false), Destroyed(false)
+: Position(0.0f, 0.0f), Size(1.0f, 1.0f), Velocity(0.0f), PrevPosition(0.0f, 0.0f), Color(1.0f), Rotation(0.0f), Sprite(), IsSolid(false), Destroyed(false)
 {}   
 
-GameObject::GameObject(glm::vec2 pos, glm::vec2 size, Texture2D sprite, glm::vec3 color, glm::vec2 velocity) 
-: Position(pos), Size(size), Velocity(velocity), Color(color), Rotation(0.0f), Sprite(sprite), IsSolid(false), Destroyed(false) 
+GameObject::GameObject(glm::vec2 pos, glm::vec2 size, SubTexture sprite, glm::vec3 color, glm::vec2 velocity) 
+: Position(pos), Size(size), Velocity(velocity), PrevPosition(pos), Color(color), Rotation(0.0f), Sprite(sprite), IsSolid(false), Destroyed(false) 
 {}
 
 void GameObject::Draw(SpriteRenderer &renderer)
 {
     renderer.DrawSprite(this->Sprite, this->Position, this->Size, this->Rotation, this->Color);
+}
+
+void GameObject::Draw(RenderQueue &queue, unsigned int layer, unsigned int depth, float alpha)
+{
+    glm::vec2 position = glm::mix(this->PrevPosition, this->Position, alpha);
+    queue.PushSprite(layer, depth, this->Sprite, position, this->Size, this->Rotation, this->Color);
 }
\ No newline at end of file
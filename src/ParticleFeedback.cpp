@@ -0,0 +1,138 @@
+#include "ParticleFeedback.h"
+#include "GLState.h"
+
+#include <algorithm>
+#include <cstddef>
+
+ParticleFeedback::ParticleFeedback(Shader updateShader, unsigned int capacity, unsigned int quadVBO, float fadeRate)
+    : updateShader(updateShader), capacity(capacity), fadeRate(fadeRate), current(0), next(0), used(0), live(0), clock(0.0), deaths(capacity, 0.0)
+{
+    this->dtLocation = this->updateShader.GetUniformLocation("dt");
+    this->fadeLocation = this->updateShader.GetUniformLocation("fadeRate");
+
+    // zeroed slots are dead and collapsed by particle.vs
+    std::vector<GPUParticle> empty(capacity, GPUParticle{ glm::vec2(0.0f), glm::vec2(0.0f), glm::vec4(0.0f), 0.0f });
+    glGenBuffers(2, this->buffers);
+    glGenVertexArrays(2, this->updateVAOs);
+    glGenVertexArrays(2, this->renderVAOs);
+    for (unsigned int i = 0; i < 2; ++i)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, this->buffers[i]);
+        glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(GPUParticle), empty.data(), GL_DYNAMIC_COPY);
+
+        // update input: the whole particle
+        GLState::BindVertexArray(this->updateVAOs[i]);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(GPUParticle), (void*)offsetof(GPUParticle, Position));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(GPUParticle), (void*)offsetof(GPUParticle, Velocity));
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(GPUParticle), (void*)offsetof(GPUParticle, Color));
+        glEnableVertexAttribArray(3);
+        glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(GPUParticle), (void*)offsetof(GPUParticle, Life));
+
+        // rendering: the shared quad plus per-instance position and color
+        GLState::BindVertexArray(this->renderVAOs[i]);
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(GPUParticle), (void*)offsetof(GPUParticle, Position));
+        glVertexAttribDivisor(1, 1);
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(GPUParticle), (void*)offsetof(GPUParticle, Color));
+        glVertexAttribDivisor(2, 1);
+        glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GLState::BindVertexArray(0);
+    this->spawns.reserve(capacity);
+}
+
+ParticleFeedback::~ParticleFeedback()
+{
+    for (unsigned int i = 0; i < 2; ++i)
+    {
+        GLState::DeleteVertexArray(this->updateVAOs[i]);
+        GLState::DeleteVertexArray(this->renderVAOs[i]);
+    }
+    glDeleteBuffers(2, this->buffers);
+}
+
+unsigned int ParticleFeedback::Capacity() const
+{
+    return this->capacity;
+}
+
+unsigned int ParticleFeedback::Used() const
+{
+    return this->used;
+}
+
+unsigned int ParticleFeedback::Live() const
+{
+    return this->live;
+}
+
+void ParticleFeedback::Spawn(glm::vec2 position, glm::vec2 velocity, glm::vec4 color, float life)
+{
+    this->spawns.push_back(GPUParticle{ position, velocity, color, life });
+}
+
+void ParticleFeedback::Update(float dt)
+{
+    // copy the queued particles into the ring; only the newest capacity particles can survive
+    unsigned int count = this->spawns.size(), first = 0;
+    if (count > this->capacity)
+    {
+        first = count - this->capacity;
+        this->next = (this->next + first) % this->capacity;
+        count = this->capacity;
+    }
+    while (count > 0)
+    {
+        unsigned int run = std::min(count, this->capacity - this->next);
+        this->upload(this->next, first, run);
+        this->used = std::max(this->used, this->next + run);
+        this->next = (this->next + run) % this->capacity;
+        first += run;
+        count -= run;
+    }
+    this->spawns.clear();
+    if (this->used == 0)
+        return;
+
+    this->clock += dt;
+    this->live = 0;
+    for (unsigned int i = 0; i < this->used; ++i)
+        this->live += this->deaths[i] > this->clock;
+
+    // advance every used slot into the other buffer
+    this->updateShader.Use();
+    this->updateShader.SetFloat(this->dtLocation, dt);
+    this->updateShader.SetFloat(this->fadeLocation, this->fadeRate);
+    glEnable(GL_RASTERIZER_DISCARD);
+    GLState::BindVertexArray(this->updateVAOs[this->current]);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, this->buffers[1 - this->current]);
+    glBeginTransformFeedback(GL_POINTS);
+    glDrawArrays(GL_POINTS, 0, this->used);
+    glEndTransformFeedback();
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    glDisable(GL_RASTERIZER_DISCARD);
+    GLState::BindVertexArray(0);
+    this->current = 1 - this->current;
+}
+
+unsigned int ParticleFeedback::Bind()
+{
+    GLState::BindVertexArray(this->renderVAOs[this->current]);
+    return this->used;
+}
+
+void ParticleFeedback::upload(unsigned int slot, unsigned int first, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; ++i)
+        this->deaths[slot + i] = this->clock + this->spawns[first + i].Life;
+    glBindBuffer(GL_ARRAY_BUFFER, this->buffers[this->current]);
+    glBufferSubData(GL_ARRAY_BUFFER, slot * sizeof(GPUParticle), count * sizeof(GPUParticle), &this->spawns[first]);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
@@ -1,50 +1,102 @@
 #include "ParticleGenerator.h"
+#include "GLState.h"
 
-ParticleGenerator::ParticleGenerator(Shader shader, Texture2D texture, unsigned int amount)
-: shader(shader), texture(texture), amount(amount) {
+#include <cstddef>
+#include <cstring>
+
+ParticleGenerator::ParticleGenerator(Shader shader, Texture2D texture, unsigned int amount, OverflowPolicy overflow)
+: DrawCalls(0), particles(amount, 2.5f, overflow), amount(amount), shader(shader), texture(texture), instanceBuffer(nullptr), feedback(nullptr) {
     this->init();
 }
 
+ParticleGenerator::ParticleGenerator(Shader shader, Shader updateShader, Texture2D texture, unsigned int amount)
+: DrawCalls(0), particles(0), amount(amount), shader(shader), texture(texture), instanceBuffer(nullptr), feedback(nullptr) {
+    this->init();
+    this->feedback = new ParticleFeedback(updateShader, amount, this->quadVBO);
+}
+
+ParticleGenerator::~ParticleGenerator()
+{
+    delete this->feedback;
+    GLState::DeleteVertexArray(this->VAO);
+    glDeleteBuffers(1, &this->quadVBO);
+    delete this->instanceBuffer;
+}
+
 void ParticleGenerator::Update(float dt, GameObject &object, unsigned int newParticles, glm::vec2 offset)
 {
     // add new particles 
     for (unsigned int i = 0; i < newParticles; ++i){
-        int unusedParticle = this->firstUnusedParticle();
-        this->respawnParticle(this->particles[unusedParticle], object, offset);
+        this->respawnParticle(object, offset);
     }
+    this->Update(dt);
+}
 
-    // update all particles
-    for (unsigned int i = 0; i < this->amount; ++i){
-        Particle &p = this->particles[i];
-        p.Life -= dt; // reduce life
-        if (p.Life > 0.0f) {	// particle is alive, thus update
-            p.Position -= p.Velocity * dt; 
-            p.Color.a -= dt * 2.5f;
-        }
-    }
+void ParticleGenerator::Update(float dt)
+{
+    // update the live particles; dead ones are compacted away (on the GPU every used slot is advanced)
+    if (this->feedback)
+        this->feedback->Update(dt);
+    else
+        this->particles.Update(dt);
 }
 
 void ParticleGenerator::Draw(){
-    // use additive blending to give it a 'glow' effect
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-    this->shader.Use();
-    for (Particle particle : this->particles) {
-        if (particle.Life > 0.0f) {
-            this->shader.SetVector2f("offset", particle.Position);
-            this->shader.SetVector4f("color", particle.Color);
-            this->texture.Bind();
-            glBindVertexArray(this->VAO);
-            glDrawArrays(GL_TRIANGLES, 0, 6);
-            glBindVertexArray(0);
-        }
+    unsigned int count = this->feedback ? this->feedback->Bind() : this->bindInstances();
+    if (count > 0) {
+        // use additive blending to give it a 'glow' effect
+        GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE);
+        this->shader.Use();
+        GLState::ActiveTexture(GL_TEXTURE0);
+        this->texture.Bind();
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 6, count);
+        this->DrawCalls++;
+        // don't forget to reset to default blending mode
+        GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    }
+    if (this->instanceBuffer)
+        this->instanceBuffer->EndFrame();
+}
+
+void ParticleGenerator::ResetStats(){
+    this->DrawCalls = 0;
+}
+
+unsigned int ParticleGenerator::bindInstances(){
+    unsigned int live = this->particles.Live;
+    if (live == 0)
+        return 0;
+
+    // a growing pool needs a bigger instance ring
+    if (this->particles.Capacity() > this->amount) {
+        delete this->instanceBuffer;
+        this->amount = this->particles.Capacity();
+        this->instanceBuffer = new StreamBuffer(this->amount * sizeof(ParticleInstance));
+    }
+
+    // write the live particles straight into the instance ring
+    unsigned int offset;
+    ParticleInstance *instances = (ParticleInstance*)this->instanceBuffer->Map(live * sizeof(ParticleInstance), sizeof(float), offset);
+    if (instances == nullptr)
+        return 0;
+    const ParticlePool &p = this->particles;
+    for (unsigned int i = 0; i < live; ++i) {
+        instances[i].Offset = glm::vec2(p.X[i], p.Y[i]);
+        instances[i].Color = glm::vec4(p.R[i], p.G[i], p.B[i], p.A[i]);
     }
-    // don't forget to reset to default blending mode
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    this->instanceBuffer->Unmap();
+
+    GLState::BindVertexArray(this->VAO);
+    // GL 3.3 has no base instance, point the per-instance attributes at this frame's range instead
+    glBindBuffer(GL_ARRAY_BUFFER, this->instanceBuffer->ID);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance), (void*)(offset + offsetof(ParticleInstance, Offset)));
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance), (void*)(offset + offsetof(ParticleInstance, Color)));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return live;
 }
 
 void ParticleGenerator::init(){
     // set up mesh and attribute properties
-    unsigned int VBO;
     float particle_quad[] = {
         0.0f, 1.0f, 0.0f, 1.0f,
         1.0f, 0.0f, 1.0f, 0.0f,
@@ -55,49 +107,55 @@ void ParticleGenerator::init(){
         1.0f, 0.0f, 1.0f, 0.0f
     }; 
     glGenVertexArrays(1, &this->VAO);
-    glGenBuffers(1, &VBO);
-    glBindVertexArray(this->VAO);
+    glGenBuffers(1, &this->quadVBO);
+    GLState::BindVertexArray(this->VAO);
     // fill mesh buffer
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, this->quadVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(particle_quad), particle_quad, GL_STATIC_DRAW);
     // set mesh attributes
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-    glBindVertexArray(0);
+    // per-instance offset and color; pointers are set per draw
+    glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(2, 1);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GLState::BindVertexArray(0);
 
-    // create this->amount default particle instances
-    for (unsigned int i = 0; i < this->amount; ++i){
-        this->particles.push_back(Particle());
-    }
+    // room for the whole pool every frame
+    if (this->particles.Capacity() > 0)
+        this->instanceBuffer = new StreamBuffer(this->amount * sizeof(ParticleInstance));
 }
 
-// stores the index of the last particle used (for quick access to next dead particle)
-unsigned int lastUsedParticle = 0;
-unsigned int ParticleGenerator::firstUnusedParticle(){
-    // first search from last used particle, this will usually return almost instantly
-    for (unsigned int i = lastUsedParticle; i < this->amount; ++i){
-        if (this->particles[i].Life <= 0.0f){
-            lastUsedParticle = i;
-            return i;
-        }
-    }
-    // otherwise, do a linear search
-    for (unsigned int i = 0; i < lastUsedParticle; ++i){
-        if (this->particles[i].Life <= 0.0f){
-            lastUsedParticle = i;
-            return i;
-        }
-    }
-    // all particles are taken, override the first one (note that if it repeatedly hits this case, more particles should be reserved)
-    lastUsedParticle = 0;
-    return 0;
-}
-
-void ParticleGenerator::respawnParticle(Particle &particle, GameObject &object, glm::vec2 offset){
+void ParticleGenerator::respawnParticle(GameObject &object, glm::vec2 offset){
     float random = ((rand() % 100) - 50) / 10.0f;
     float rColor = 0.5f + ((rand() % 100) / 100.0f);
-    particle.Position = object.Position + random + offset;
-    particle.Color = glm::vec4(rColor, rColor, rColor, 1.0f);
-    particle.Life = 1.0f;
-    particle.Velocity = object.Velocity * 0.1f;
+    glm::vec2 position = object.Position + random + offset;
+    glm::vec4 color = glm::vec4(rColor, rColor, rColor, 1.0f);
+    this->Spawn(position, object.Velocity * 0.1f, color, 1.0f);
+}
+
+void ParticleGenerator::Spawn(glm::vec2 position, glm::vec2 velocity, glm::vec4 color, float life) {
+    // a full pool is handled by its overflow policy
+    if (this->feedback)
+        this->feedback->Spawn(position, velocity, color, life);
+    else
+        this->particles.Spawn(position, velocity, color, life);
+}
+
+unsigned int ParticleGenerator::Count() const {
+    return this->feedback ? this->feedback->Live() : this->particles.Live;
+}
+
+unsigned int ParticleGenerator::Capacity() const {
+    return this->feedback ? this->feedback->Capacity() : this->particles.Capacity();
+}
+
+const ParticlePool &ParticleGenerator::GetPool() const {
+    return this->particles;
+}
+
+bool ParticleGenerator::OnGPU() const {
+    return this->feedback != nullptr;
 }
\ No newline at end of file
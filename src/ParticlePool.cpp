@@ -0,0 +1,159 @@
+#include "ParticlePool.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define PARTICLE_POOL_AVX
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define PARTICLE_POOL_SSE
+#endif
+
+ParticlePool::ParticlePool(unsigned int capacity, float fadeRate, OverflowPolicy overflow)
+    : X(capacity), Y(capacity), VX(capacity), VY(capacity), R(capacity), G(capacity), B(capacity), A(capacity), Life(capacity),
+      Live(0), FadeRate(fadeRate), Overflow(overflow), Spawned(0), Dropped(0), Stolen(0), Grown(0), stealCursor(0)
+{
+}
+
+unsigned int ParticlePool::Capacity() const
+{
+    return this->Life.size();
+}
+
+bool ParticlePool::Spawn(glm::vec2 position, glm::vec2 velocity, glm::vec4 color, float life)
+{
+    if (this->Live >= this->Capacity())
+    {
+        if (this->Overflow == OVERFLOW_DROP || this->Capacity() == 0)
+        {
+            this->Dropped++;
+            return false;
+        }
+        if (this->Overflow == OVERFLOW_STEAL_OLDEST)
+        {
+            // the replaced particle becomes the newest, so the cursor moves on to the next oldest
+            this->Set(this->stealCursor, position, velocity, color, life);
+            this->stealCursor = (this->stealCursor + 1) % this->Live;
+            this->Stolen++;
+            this->Spawned++;
+            return true;
+        }
+        this->resize(this->Capacity() * 2);
+        this->Grown++;
+    }
+    this->Set(this->Live++, position, velocity, color, life);
+    this->Spawned++;
+    return true;
+}
+
+void ParticlePool::ResetStats()
+{
+    this->Spawned = 0;
+    this->Dropped = 0;
+    this->Stolen = 0;
+    this->Grown = 0;
+}
+
+void ParticlePool::resize(unsigned int capacity)
+{
+    this->X.resize(capacity);
+    this->Y.resize(capacity);
+    this->VX.resize(capacity);
+    this->VY.resize(capacity);
+    this->R.resize(capacity);
+    this->G.resize(capacity);
+    this->B.resize(capacity);
+    this->A.resize(capacity);
+    this->Life.resize(capacity);
+}
+
+void ParticlePool::Set(unsigned int index, glm::vec2 position, glm::vec2 velocity, glm::vec4 color, float life)
+{
+    this->X[index] = position.x;
+    this->Y[index] = position.y;
+    this->VX[index] = velocity.x;
+    this->VY[index] = velocity.y;
+    this->R[index] = color.r;
+    this->G[index] = color.g;
+    this->B[index] = color.b;
+    this->A[index] = color.a;
+    this->Life[index] = life;
+}
+
+// scalar kernel for particles [begin, end)
+static void updateRange(float *__restrict x, float *__restrict y, const float *__restrict vx, const float *__restrict vy,
+                        float *__restrict a, float *__restrict life, unsigned int begin, unsigned int end, float dt, float fade)
+{
+    for (unsigned int i = begin; i < end; ++i)
+    {
+        life[i] -= dt;
+        x[i] -= vx[i] * dt;
+        y[i] -= vy[i] * dt;
+        a[i] -= fade;
+    }
+}
+
+void ParticlePool::Update(float dt)
+{
+    float *x = this->X.data(), *y = this->Y.data(), *a = this->A.data(), *life = this->Life.data();
+    const float *vx = this->VX.data(), *vy = this->VY.data();
+    float fade = dt * this->FadeRate;
+    unsigned int i = 0, count = this->Live;
+#if defined(PARTICLE_POOL_AVX)
+    const __m256 dtv = _mm256_set1_ps(dt), fadev = _mm256_set1_ps(fade);
+    for (; i + 8 <= count; i += 8)
+    {
+        _mm256_storeu_ps(life + i, _mm256_sub_ps(_mm256_loadu_ps(life + i), dtv));
+        _mm256_storeu_ps(x + i, _mm256_sub_ps(_mm256_loadu_ps(x + i), _mm256_mul_ps(_mm256_loadu_ps(vx + i), dtv)));
+        _mm256_storeu_ps(y + i, _mm256_sub_ps(_mm256_loadu_ps(y + i), _mm256_mul_ps(_mm256_loadu_ps(vy + i), dtv)));
+        _mm256_storeu_ps(a + i, _mm256_sub_ps(_mm256_loadu_ps(a + i), fadev));
+    }
+#elif defined(PARTICLE_POOL_SSE)
+    const __m128 dtv = _mm_set1_ps(dt), fadev = _mm_set1_ps(fade);
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(life + i, _mm_sub_ps(_mm_loadu_ps(life + i), dtv));
+        _mm_storeu_ps(x + i, _mm_sub_ps(_mm_loadu_ps(x + i), _mm_mul_ps(_mm_loadu_ps(vx + i), dtv)));
+        _mm_storeu_ps(y + i, _mm_sub_ps(_mm_loadu_ps(y + i), _mm_mul_ps(_mm_loadu_ps(vy + i), dtv)));
+        _mm_storeu_ps(a + i, _mm_sub_ps(_mm_loadu_ps(a + i), fadev));
+    }
+#endif
+    // remainder
+    updateRange(x, y, vx, vy, a, life, i, count, dt, fade);
+    this->compact();
+}
+
+void ParticlePool::UpdateScalar(float dt)
+{
+    updateRange(this->X.data(), this->Y.data(), this->VX.data(), this->VY.data(), this->A.data(), this->Life.data(),
+                0, this->Live, dt, dt * this->FadeRate);
+    this->compact();
+}
+
+void ParticlePool::compact()
+{
+    // nothing moves until the first dead particle
+    unsigned int read = 0, count = this->Live, cursor = this->stealCursor;
+    while (read < count && this->Life[read] > 0.0f)
+        ++read;
+    unsigned int write = read;
+    for (; read < count; ++read)
+    {
+        // keep the steal cursor on the same (or the next surviving) particle
+        if (read == this->stealCursor)
+            cursor = write;
+        if (this->Life[read] <= 0.0f)
+            continue;
+        this->X[write] = this->X[read];
+        this->Y[write] = this->Y[read];
+        this->VX[write] = this->VX[read];
+        this->VY[write] = this->VY[read];
+        this->R[write] = this->R[read];
+        this->G[write] = this->G[read];
+        this->B[write] = this->B[read];
+        this->A[write] = this->A[read];
+        this->Life[write] = this->Life[read];
+        ++write;
+    }
+    this->Live = write;
+    this->stealCursor = cursor < write ? cursor : 0;
+}
@@ -0,0 +1,137 @@
+#include "ParticleSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+ParticleEmitter::ParticleEmitter()
+    : Position(0.0f), Offset(0.0f), Velocity(0.0f), Speed(0.0f), Spread(5.0f), Color(1.0f), Life(1.0f),
+      Rate(0.0f), Burst(0), Duration(-1.0f), Follow(nullptr), VelocityScale(0.1f), Accumulator(0.0f), Alive(true) { }
+
+ParticleSystem::ParticleSystem(ParticleGenerator *generator, unsigned int budget)
+    : Budget(budget), Throttle(1.0f), Throttled(0), generator(generator)
+{
+}
+
+ParticleSystem::~ParticleSystem()
+{
+    delete this->generator;
+}
+
+unsigned int ParticleSystem::AddEmitter(const ParticleEmitter &emitter)
+{
+    if (!this->freeEmitters.empty())
+    {
+        unsigned int handle = this->freeEmitters.back();
+        this->freeEmitters.pop_back();
+        this->emitters[handle] = emitter;
+        this->emitters[handle].Alive = true;
+        return handle;
+    }
+    this->emitters.push_back(emitter);
+    this->emitters.back().Alive = true;
+    return this->emitters.size() - 1;
+}
+
+ParticleEmitter &ParticleSystem::GetEmitter(unsigned int handle)
+{
+    return this->emitters[handle];
+}
+
+void ParticleSystem::RemoveEmitter(unsigned int handle)
+{
+    if (handle >= this->emitters.size() || !this->emitters[handle].Alive)
+        return;
+    this->emitters[handle].Alive = false;
+    this->freeEmitters.push_back(handle);
+}
+
+void ParticleSystem::Burst(glm::vec2 position, unsigned int count, glm::vec3 color, float speed, float life)
+{
+    ParticleEmitter burst;
+    burst.Position = position;
+    burst.Burst = count;
+    burst.Speed = speed;
+    burst.Color = color;
+    burst.Life = life;
+    burst.Duration = 0.0f;
+    this->AddEmitter(burst);
+}
+
+void ParticleSystem::Update(float dt)
+{
+    // scale emission down once more than half of the budget is alive
+    float load = this->Budget > 0 ? static_cast<float>(this->generator->Count()) / this->Budget : 1.0f;
+    this->Throttle = glm::clamp(2.0f * (1.0f - load), 0.0f, 1.0f);
+
+    for (unsigned int i = 0; i < this->emitters.size(); ++i)
+    {
+        ParticleEmitter &emitter = this->emitters[i];
+        if (!emitter.Alive)
+            continue;
+        if (emitter.Follow != nullptr)
+        {
+            emitter.Position = emitter.Follow->Position + emitter.Offset;
+            emitter.Velocity = emitter.Follow->Velocity * emitter.VelocityScale;
+        }
+        // rate based emission; the fractional remainder carries over to the next frame
+        emitter.Accumulator += emitter.Rate * dt;
+        float wanted = std::floor(emitter.Accumulator) + emitter.Burst;
+        emitter.Accumulator -= std::floor(emitter.Accumulator);
+        emitter.Burst = 0;
+        unsigned int count = static_cast<unsigned int>(wanted * this->Throttle);
+        this->Throttled += static_cast<unsigned int>(wanted) - count;
+        this->emit(emitter, count);
+
+        if (emitter.Duration >= 0.0f)
+        {
+            emitter.Duration -= dt;
+            if (emitter.Duration <= 0.0f)
+                this->RemoveEmitter(i);
+        }
+    }
+    this->generator->Update(dt);
+}
+
+void ParticleSystem::ResetStats()
+{
+    this->Throttled = 0;
+    this->generator->ResetStats();
+}
+
+void ParticleSystem::Draw()
+{
+    this->generator->Draw();
+}
+
+ParticleGenerator &ParticleSystem::GetGenerator()
+{
+    return *this->generator;
+}
+
+unsigned int ParticleSystem::Count() const
+{
+    return this->generator->Count();
+}
+
+unsigned int ParticleSystem::Emitters() const
+{
+    return this->emitters.size() - this->freeEmitters.size();
+}
+
+void ParticleSystem::emit(const ParticleEmitter &emitter, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        float jitter = ((rand() % 100) - 50) / 50.0f * emitter.Spread;
+        float brightness = 0.5f + ((rand() % 100) / 100.0f);
+        glm::vec2 velocity = emitter.Velocity;
+        if (emitter.Speed > 0.0f)
+        {
+            float angle = (rand() % 360) * 0.0174533f;
+            float speed = emitter.Speed * (0.25f + 0.75f * (rand() % 100) / 100.0f);
+            velocity += glm::vec2(std::cos(angle), std::sin(angle)) * speed;
+        }
+        this->generator->Spawn(emitter.Position + jitter, velocity, glm::vec4(emitter.Color * brightness, 1.0f), emitter.Life);
+    }
+}
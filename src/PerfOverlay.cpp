@@ -0,0 +1,140 @@
+#include "PerfOverlay.h"
+#include "GLState.h"
+
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <cstdio>
+
+// seconds between text refreshes
+static const double REFRESH_INTERVAL = 0.25;
+// graph layout, in board units
+static const float BAR_WIDTH = 1.25f, GRAPH_HEIGHT = 60.0f;
+static const float TEXT_SCALE = 0.6f, LINE_HEIGHT = 16.0f, PADDING = 4.0f;
+// number of text lines the panel has room for
+static const unsigned int MAX_LINES = 7;
+
+PerfOverlay::PerfOverlay(float budgetMilliseconds)
+    : Visible(false), Position(5.0f, 35.0f), GraphMilliseconds(2.0f * budgetMilliseconds), BudgetMilliseconds(budgetMilliseconds),
+      OwnMilliseconds(0.0f), white(), frameTimes(PERF_LOW_FRAMES, 0.0f), gpuTimes(PERF_LOW_FRAMES, 0.0f),
+      frames(0), lastFrame(-1.0), lastRefresh(0.0), counters()
+{
+    unsigned char pixel[4] = { 255, 255, 255, 255 };
+    this->white.Texture.Internal_Format = GL_RGBA;
+    this->white.Texture.Image_Format = GL_RGBA;
+    this->white.Texture.Generate(1, 1, pixel);
+    this->sorted.reserve(PERF_LOW_FRAMES);
+}
+
+PerfOverlay::~PerfOverlay()
+{
+    GLState::DeleteTexture(this->white.Texture.ID);
+}
+
+void PerfOverlay::Frame(const PerfCounters &counters)
+{
+    double now = glfwGetTime();
+    this->counters = counters;
+    // the first call only starts the clock, the time before it went into loading
+    if (this->lastFrame < 0.0)
+    {
+        this->lastFrame = now;
+        return;
+    }
+    unsigned int slot = this->frames % PERF_LOW_FRAMES;
+    this->frameTimes[slot] = static_cast<float>((now - this->lastFrame) * 1000.0);
+    this->gpuTimes[slot] = counters.GPUMilliseconds;
+    this->lastFrame = now;
+    this->frames++;
+}
+
+void PerfOverlay::Draw(SpriteRenderer &renderer, TextRenderer &text)
+{
+    double start = glfwGetTime();
+    if (start - this->lastRefresh >= REFRESH_INTERVAL)
+    {
+        this->lastRefresh = start;
+        this->refresh();
+    }
+
+    float width = PERF_GRAPH_FRAMES * BAR_WIDTH;
+    glm::vec2 graph = this->Position + glm::vec2(PADDING);
+    float bottom = graph.y + GRAPH_HEIGHT;
+
+    renderer.Begin();
+    // panel behind the graph and the text
+    renderer.Submit(this->white, this->Position, glm::vec2(width, GRAPH_HEIGHT + MAX_LINES * LINE_HEIGHT) + 3.0f * PADDING, 0.0f, glm::vec3(0.08f));
+    // newest frame on the right; wall clock bars colored by how far over budget they are, gpu bars on top
+    unsigned int count = std::min(this->frames, PERF_GRAPH_FRAMES);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        unsigned int slot = (this->frames - count + i) % PERF_LOW_FRAMES;
+        float x = graph.x + (PERF_GRAPH_FRAMES - count + i) * BAR_WIDTH;
+        float frame = this->frameTimes[slot], gpu = this->gpuTimes[slot];
+        float h = std::min(frame / this->GraphMilliseconds, 1.0f) * GRAPH_HEIGHT;
+        glm::vec3 color = frame <= this->BudgetMilliseconds ? glm::vec3(0.2f, 0.8f, 0.2f)
+            : frame <= 2.0f * this->BudgetMilliseconds ? glm::vec3(0.9f, 0.8f, 0.1f) : glm::vec3(0.9f, 0.2f, 0.1f);
+        renderer.Submit(this->white, glm::vec2(x, bottom - h), glm::vec2(BAR_WIDTH, h), 0.0f, color);
+        h = std::min(gpu / this->GraphMilliseconds, 1.0f) * GRAPH_HEIGHT;
+        renderer.Submit(this->white, glm::vec2(x, bottom - h), glm::vec2(BAR_WIDTH * 0.5f, h), 0.0f, glm::vec3(0.3f, 0.5f, 1.0f));
+    }
+    float budget = bottom - std::min(this->BudgetMilliseconds / this->GraphMilliseconds, 1.0f) * GRAPH_HEIGHT;
+    renderer.Submit(this->white, glm::vec2(graph.x, budget), glm::vec2(width, 1.0f), 0.0f, glm::vec3(0.8f));
+    renderer.End();
+
+    float y = bottom + PADDING;
+    for (const std::string &line : this->lines)
+    {
+        // the numbers change with every refresh, laying them out is cheaper than evicting the game's cached strings
+        text.RenderText(line, graph.x, y, TEXT_SCALE, glm::vec3(1.0f), false);
+        y += LINE_HEIGHT;
+    }
+    this->OwnMilliseconds = static_cast<float>((glfwGetTime() - start) * 1000.0);
+}
+
+void PerfOverlay::refresh()
+{
+    const PerfCounters &c = this->counters;
+    // average over the graph's frames
+    unsigned int count = std::min(this->frames, PERF_GRAPH_FRAMES);
+    float average = 0.0f;
+    for (unsigned int i = 0; i < count; ++i)
+        average += this->frameTimes[(this->frames - 1 - i) % PERF_LOW_FRAMES];
+    if (count > 0)
+        average /= count;
+
+    char line[160];
+    this->lines.clear();
+    std::snprintf(line, sizeof(line), "frame %.2f ms (%.0f fps)  cpu %.2f  gpu %.2f", average, average > 0.0f ? 1000.0f / average : 0.0f,
+        c.CPUMilliseconds, c.GPUMilliseconds);
+    this->lines.push_back(line);
+    float low1 = this->low(0.01f), low01 = this->low(0.001f);
+    std::snprintf(line, sizeof(line), "1%% low %.2f ms (%.0f fps)  0.1%% low %.2f ms (%.0f fps)",
+        low1, low1 > 0.0f ? 1000.0f / low1 : 0.0f, low01, low01 > 0.0f ? 1000.0f / low01 : 0.0f);
+    this->lines.push_back(line);
+    std::snprintf(line, sizeof(line), "draws %u  blits %u  state calls %u (%u skipped)  queue switches %u",
+        c.DrawCalls, c.Blits, c.StateChanges, c.SkippedChanges, c.QueueStateChanges);
+    this->lines.push_back(line);
+    std::snprintf(line, sizeof(line), "particles %u/%u  bricks %u/%u  power-ups %u",
+        c.Particles, c.ParticleCapacity, c.Bricks, c.BricksTotal, c.PowerUps);
+    this->lines.push_back(line);
+    std::snprintf(line, sizeof(line), "textures %.1f MB  scale %.2f  msaa %ux",
+        c.TextureBytes / (1024.0f * 1024.0f), c.Scale, c.Samples);
+    this->lines.push_back(line);
+    if (!c.LastResolutionChange.empty())
+        this->lines.push_back(c.LastResolutionChange);
+    std::snprintf(line, sizeof(line), "overlay %.3f ms", this->OwnMilliseconds);
+    this->lines.push_back(line);
+}
+
+float PerfOverlay::low(float fraction)
+{
+    unsigned int count = std::min(this->frames, PERF_LOW_FRAMES);
+    if (count == 0)
+        return 0.0f;
+    // the ring is full or filled from the start, either way its first count entries are the frames
+    this->sorted.assign(this->frameTimes.begin(), this->frameTimes.begin() + count);
+    unsigned int index = std::min(count - 1, static_cast<unsigned int>(count * (1.0f - fraction)));
+    std::nth_element(this->sorted.begin(), this->sorted.begin() + index, this->sorted.end());
+    return this->sorted[index];
+}
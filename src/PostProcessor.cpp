@@ -1,8 +1,11 @@
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include "PostProcessor.h"
+#include "GLState.h"
 
-PostProcessor::PostProcessor(Shader shader, unsigned int width, unsigned int height) 
-    : PostProcessingShader(shader), Texture(), Width(width), Height(height), Confuse(false), Chaos(false), Shake(false)
+PostProcessor::PostProcessor(Shader blitShader, unsigned int width, unsigned int height) 
+    : BlitShader(blitShader), Texture(), Width(width), Height(height), Scale(1.0f), Samples(0), Confuse(false), Chaos(false), Shake(false), Bypassed(false), DrawCalls(0), Blits(0), viewport()
 {
     // initialize renderbuffer/framebuffer object
     glGenFramebuffers(1, &this->MSFBO);
@@ -14,7 +17,8 @@ PostProcessor::PostProcessor(Shader shader, unsigned int width, unsigned int hei
     glBindRenderbuffer(GL_RENDERBUFFER, this->RBO);
     GLint max_samples;
     glGetIntegerv(GL_MAX_SAMPLES, &max_samples);
-    glRenderbufferStorageMultisample(GL_RENDERBUFFER, 4, GL_RGB, width, height); // allocate storage for render buffer object
+    this->maxSamples = max_samples > 1 ? max_samples : 1;
+    this->SetSamples(4); // allocate storage for render buffer object
 
     glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, this->RBO); // attach MS render buffer object to framebuffer
     
@@ -35,63 +39,234 @@ PostProcessor::PostProcessor(Shader shader, unsigned int width, unsigned int hei
 
     // initialize render data and uniforms
     this->initRenderData();
-    this->PostProcessingShader.SetInteger("scene", 0, true);
-    float offset = 1.0f / 300.0f;
-    float offsets[9][2] = {
-        { -offset,  offset  },  // top-left
-        {  0.0f,    offset  },  // top-center
-        {  offset,  offset  },  // top-right
-        { -offset,  0.0f    },  // center-left
-        {  0.0f,    0.0f    },  // center-center
-        {  offset,  0.0f    },  // center - right
-        { -offset, -offset  },  // bottom-left
-        {  0.0f,   -offset  },  // bottom-center
-        {  offset, -offset  }   // bottom-right    
-    };
-    glUniform2fv(glGetUniformLocation(this->PostProcessingShader.ID, "offsets"), 9, (float*)offsets);
-    int edge_kernel[9] = {
-        -1, -1, -1,
-        -1,  8, -1,
-        -1, -1, -1
-    };
-    glUniform1iv(glGetUniformLocation(this->PostProcessingShader.ID, "edge_kernel"), 9, edge_kernel);
-    float blur_kernel[9] = {
-        1.0f / 16.0f, 2.0f / 16.0f, 1.0f / 16.0f,
-        2.0f / 16.0f, 4.0f / 16.0f, 2.0f / 16.0f,
-        1.0f / 16.0f, 2.0f / 16.0f, 1.0f / 16.0f
-    };
-    glUniform1fv(glGetUniformLocation(this->PostProcessingShader.ID, "blur_kernel"), 9, blur_kernel);    
+    this->BlitShader.SetInteger("image", 0, true);
+}
+
+unsigned int PostProcessor::AddPass(std::string name, Shader program, bool separable, int radius)
+{
+    PostPass pass = { name, false, program, separable, radius, glm::vec2(1.0f / 300.0f), glm::vec2(1.0f), glm::vec2(0.0f), 0.0f, 0.0f };
+    pass.Program.SetInteger("scene", 0, true);
+    pass.RegionLocation = program.GetUniformLocation("region");
+    pass.UVScaleLocation = program.GetUniformLocation("uvScale");
+    pass.UVOffsetLocation = program.GetUniformLocation("uvOffset");
+    pass.SwirlLocation = program.GetUniformLocation("swirl");
+    pass.JitterLocation = program.GetUniformLocation("jitter");
+    pass.TexelLocation = program.GetUniformLocation("texel");
+    pass.RadiusLocation = program.GetUniformLocation("radius");
+    pass.WeightsLocation = program.GetUniformLocation("weights");
+    this->Passes.push_back(pass);
+    return static_cast<unsigned int>(this->Passes.size() - 1);
+}
+
+PostPass *PostProcessor::GetPass(const std::string &name)
+{
+    for (PostPass &pass : this->Passes)
+        if (pass.Name == name)
+            return &pass;
+    return nullptr;
+}
+
+void PostProcessor::SetScale(float scale)
+{
+    this->Scale = glm::clamp(scale, 0.1f, 1.0f);
+}
+
+void PostProcessor::SetSamples(unsigned int samples)
+{
+    samples = glm::clamp(samples, 1u, this->maxSamples);
+    if (samples == this->Samples)
+        return;
+    this->Samples = samples;
+    glBindRenderbuffer(GL_RENDERBUFFER, this->RBO);
+    glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples > 1 ? samples : 0, GL_RGB, this->Width, this->Height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+}
+
+void PostProcessor::Resize(unsigned int width, unsigned int height)
+{
+    if (width == this->Width && height == this->Height)
+        return;
+    this->Width = width;
+    this->Height = height;
+    // multisampled storage at the current sample count
+    unsigned int samples = this->Samples;
+    this->Samples = 0;
+    this->SetSamples(samples);
+    // respecifying the texture keeps it attached to the FBO
+    this->Texture.Generate(width, height, NULL);
+    // pooled intermediate targets have the old size
+    this->targets.Clear();
+}
+
+unsigned int PostProcessor::RenderWidth() const
+{
+    return std::max(1u, static_cast<unsigned int>(this->Width * this->Scale + 0.5f));
+}
+
+unsigned int PostProcessor::RenderHeight() const
+{
+    return std::max(1u, static_cast<unsigned int>(this->Height * this->Scale + 0.5f));
 }
 
-void PostProcessor::BeginRender()
+void PostProcessor::BeginRender(const Texture2D *underlay)
 {
+    glGetIntegerv(GL_VIEWPORT, this->viewport);
     glBindFramebuffer(GL_FRAMEBUFFER, this->MSFBO);
+    glViewport(0, 0, this->RenderWidth(), this->RenderHeight());
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
+    if (underlay)
+    {
+        this->BlitShader.Use();
+        GLState::ActiveTexture(GL_TEXTURE0);
+        underlay->Bind();
+        GLState::BindVertexArray(this->VAO);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+        this->DrawCalls++;
+    }
 }
 void PostProcessor::EndRender()
 {
-    // now resolve multisampled color-buffer into intermediate FBO to store to texture
+    this->Bypassed = !this->Active();
+    const GLint *screen = this->viewport;
+    GLint width = this->RenderWidth(), height = this->RenderHeight();
+    bool sameSize = screen[2] == width && screen[3] == height;
+    glViewport(screen[0], screen[1], screen[2], screen[3]);
+
     glBindFramebuffer(GL_READ_FRAMEBUFFER, this->MSFBO);
+    if (this->Bypassed && this->Samples <= 1)
+    {
+        // no effect and no multisampling: copy (or upscale) the scene straight onto the screen
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        glBlitFramebuffer(0, 0, width, height, screen[0], screen[1], screen[0] + screen[2], screen[1] + screen[3], GL_COLOR_BUFFER_BIT, sameSize ? GL_NEAREST : GL_LINEAR);
+        this->Blits++;
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        return;
+    }
+    // now resolve multisampled color-buffer into intermediate FBO to store to texture
     glBindFramebuffer(GL_DRAW_FRAMEBUFFER, this->FBO);
-    glBlitFramebuffer(0, 0, this->Width, this->Height, 0, 0, this->Width, this->Height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    this->Blits++;
+    if (this->Bypassed)
+    {
+        // a multisample resolve needs matching formats and can't scale, so the screen gets a second blit from the resolved texture
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, this->FBO);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        glBlitFramebuffer(0, 0, width, height, screen[0], screen[1], screen[0] + screen[2], screen[1] + screen[3], GL_COLOR_BUFFER_BIT, sameSize ? GL_NEAREST : GL_LINEAR);
+        this->Blits++;
+    }
     glBindFramebuffer(GL_FRAMEBUFFER, 0); // binds both READ and WRITE framebuffer to default framebuffer
 }
 
-void PostProcessor::Render(float time)
-{
-    // set uniforms/options
-    this->PostProcessingShader.Use();
-    this->PostProcessingShader.SetFloat("time", time);
-    this->PostProcessingShader.SetInteger("confuse", this->Confuse);
-    this->PostProcessingShader.SetInteger("chaos", this->Chaos);
-    this->PostProcessingShader.SetInteger("shake", this->Shake);
-    // render textured quad
-    glActiveTexture(GL_TEXTURE0);
-    this->Texture.Bind();	
-    glBindVertexArray(this->VAO);
+bool PostProcessor::Active() const
+{
+    for (const PostPass &pass : this->Passes)
+        if (pass.Enabled)
+            return true;
+    return false;
+}
+
+size_t PostProcessor::TextureBytes() const
+{
+    // RGB, padded to 4 bytes per texel (and sample)
+    size_t texels = static_cast<size_t>(this->Width) * this->Height;
+    return 4 * texels * std::max(this->Samples, 1u) + 4 * texels + this->targets.TextureBytes();
+}
+
+void PostProcessor::ResetStats()
+{
+    this->DrawCalls = 0;
+    this->Blits = 0;
+}
+
+void PostProcessor::Render()
+{
+    // the scene is already on screen
+    if (this->Bypassed)
+        return;
+
+    // a separable pass is split into a horizontal and a vertical step
+    struct Step { const PostPass *pass; glm::vec2 direction; bool transform; };
+    std::vector<Step> steps;
+    for (const PostPass &pass : this->Passes)
+    {
+        if (!pass.Enabled)
+            continue;
+        if (pass.Separable && pass.Radius > 0)
+        {
+            steps.push_back({ &pass, glm::vec2(1.0f, 0.0f), true });
+            steps.push_back({ &pass, glm::vec2(0.0f, 1.0f), false });
+        }
+        else
+            steps.push_back({ &pass, glm::vec2(1.0f), true });
+    }
+
+    // every step works on the render region; the last one stretches it over the screen
+    unsigned int width = this->RenderWidth(), height = this->RenderHeight();
+    glm::vec2 region(static_cast<float>(width) / this->Width, static_cast<float>(height) / this->Height);
+    const GLint *viewport = this->viewport;
+    GLState::BindVertexArray(this->VAO);
+    const Texture2D *source = &this->Texture;
+    RenderTarget *held = nullptr;
+    for (unsigned int i = 0; i < steps.size(); ++i)
+    {
+        // intermediate steps ping-pong between pooled targets, the last one draws to the screen
+        RenderTarget *target = nullptr;
+        if (i + 1 < steps.size())
+        {
+            target = this->targets.Acquire(this->Width, this->Height);
+            glBindFramebuffer(GL_FRAMEBUFFER, target->FBO);
+            glViewport(0, 0, width, height);
+            // a moved quad doesn't cover the whole target
+            if (steps[i].pass->Jitter != 0.0f)
+                glClear(GL_COLOR_BUFFER_BIT);
+        }
+        else
+        {
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+        }
+        this->drawPass(*steps[i].pass, *source, steps[i].direction, steps[i].transform, region);
+        this->targets.Release(held);
+        held = target;
+        if (target)
+            source = &target->Texture;
+    }
+    this->targets.Release(held);
+}
+
+void PostProcessor::drawPass(const PostPass &pass, const Texture2D &source, glm::vec2 direction, bool transform, glm::vec2 region)
+{
+    GLState::UseProgram(pass.Program.ID);
+    glm::vec2 uvScale = transform ? pass.UVScale : glm::vec2(1.0f), uvOffset = transform ? pass.UVOffset : glm::vec2(0.0f);
+    glm::vec2 texel = pass.Texel * direction;
+    glUniform2f(pass.RegionLocation, region.x, region.y);
+    glUniform2f(pass.UVScaleLocation, uvScale.x, uvScale.y);
+    glUniform2f(pass.UVOffsetLocation, uvOffset.x, uvOffset.y);
+    glUniform1f(pass.SwirlLocation, transform ? pass.Swirl : 0.0f);
+    glUniform1f(pass.JitterLocation, transform ? pass.Jitter : 0.0f);
+    glUniform2f(pass.TexelLocation, texel.x, texel.y);
+    if (pass.Separable)
+    {
+        // binomial weights approximate a gaussian; radius 1 is the classic 1-2-1 kernel
+        int radius = glm::clamp(pass.Radius, 0, MAX_POST_RADIUS);
+        float weights[MAX_POST_RADIUS + 1];
+        double row = 1.0, total = std::pow(2.0, 2 * radius);
+        for (int j = 1; j <= radius; ++j)
+            row = row * (radius + j) / j;
+        // row walks C(2r, r + k) outwards from the center
+        for (int k = 0; k <= radius; ++k)
+        {
+            weights[k] = static_cast<float>(row / total);
+            row = row * (radius - k) / (radius + k + 1);
+        }
+        glUniform1i(pass.RadiusLocation, radius);
+        glUniform1fv(pass.WeightsLocation, radius + 1, weights);
+    }
+    GLState::ActiveTexture(GL_TEXTURE0);
+    source.Bind();
     glDrawArrays(GL_TRIANGLES, 0, 6);
-    glBindVertexArray(0);
+    this->DrawCalls++;
 }
 
 void PostProcessor::initRenderData()
@@ -114,9 +289,9 @@ void PostProcessor::initRenderData()
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
-    glBindVertexArray(this->VAO);
+    GLState::BindVertexArray(this->VAO);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    GLState::BindVertexArray(0);
 }
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include "RenderQueue.h"
+#include "GLState.h"
+
+RenderQueue::RenderQueue()
+    : Commands(0), StateChanges(0)
+{
+}
+
+uint64_t RenderQueue::MakeKey(unsigned int layer, unsigned int blend, unsigned int shader, unsigned int texture, unsigned int depth)
+{
+    return ((uint64_t)(layer   & 0xFF)   << 56) |
+           ((uint64_t)(blend   & 0x3)    << 54) |
+           ((uint64_t)(shader  & 0xFF)   << 46) |
+           ((uint64_t)(texture & 0xFFFF) << 30) |
+           ((uint64_t)(depth   & 0xFFFF) << 14);
+}
+
+void RenderQueue::PushSprite(unsigned int layer, unsigned int depth, const SubTexture &sprite, glm::vec2 position,
+                    glm::vec2 size, float rotate, glm::vec3 color, unsigned int blend)
+{
+    // all sprites share the SpriteRenderer's program, shader bits stay 0
+    RenderCommand command = { MakeKey(layer, blend, 0, sprite.Texture.ID, depth), &sprite, position, size, rotate, color, nullptr };
+    this->commands.push_back(command);
+}
+
+void RenderQueue::PushCallback(uint64_t key, std::function<void()> callback)
+{
+    RenderCommand command = { key, nullptr, glm::vec2(0.0f), glm::vec2(0.0f), 0.0f, glm::vec3(0.0f), callback };
+    this->commands.push_back(command);
+}
+
+void RenderQueue::Submit(SpriteRenderer &renderer)
+{
+    this->sort();
+    this->Commands = this->commands.size();
+    this->StateChanges = 0;
+
+    // the state part of the key: blend, shader and texture bits
+    const uint64_t stateMask = ((uint64_t)1 << 56) - ((uint64_t)1 << 30);
+    uint64_t state = ~(uint64_t)0;
+    unsigned int blend = BLEND_ALPHA;
+    renderer.Begin();
+    for (unsigned int index : this->order)
+    {
+        RenderCommand &command = this->commands[index];
+        if ((command.Key & stateMask) != state)
+        {
+            if (state != ~(uint64_t)0)
+                this->StateChanges++;
+            state = command.Key & stateMask;
+        }
+        unsigned int commandBlend = (command.Key >> 54) & 0x3;
+        if (command.Callback)
+        {
+            // custom draws set up their own GL state; hand them everything batched so far first
+            renderer.Flush();
+            if (blend != BLEND_ALPHA)
+            {
+                GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+                blend = BLEND_ALPHA;
+            }
+            command.Callback();
+            continue;
+        }
+        if (commandBlend != blend)
+        {
+            renderer.Flush();
+            GLState::BlendFunc(GL_SRC_ALPHA, commandBlend == BLEND_ADDITIVE ? GL_ONE : GL_ONE_MINUS_SRC_ALPHA);
+            blend = commandBlend;
+        }
+        renderer.Submit(*command.Sprite, command.Position, command.Size, command.Rotate, command.Color);
+    }
+    renderer.End();
+    if (blend != BLEND_ALPHA)
+        GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    this->commands.clear();
+}
+
+void RenderQueue::sort()
+{
+    unsigned int count = this->commands.size();
+    this->keys.resize(count);
+    this->keysTemp.resize(count);
+    this->order.resize(count);
+    this->orderTemp.resize(count);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        this->keys[i] = this->commands[i].Key;
+        this->order[i] = i;
+    }
+
+    // one counting pass per byte, least significant first; stable, so equal keys keep submission order
+    for (unsigned int shift = 0; shift < 64; shift += 8)
+    {
+        unsigned int histogram[257] = { 0 };
+        for (unsigned int i = 0; i < count; ++i)
+            histogram[((this->keys[i] >> shift) & 0xFF) + 1]++;
+        // all keys share this byte: nothing to reorder
+        if (histogram[((this->keys.empty() ? 0 : this->keys[0] >> shift) & 0xFF) + 1] == count)
+            continue;
+        for (unsigned int i = 0; i < 256; ++i)
+            histogram[i + 1] += histogram[i];
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            unsigned int destination = histogram[(this->keys[i] >> shift) & 0xFF]++;
+            this->keysTemp[destination] = this->keys[i];
+            this->orderTemp[destination] = this->order[i];
+        }
+        this->keys.swap(this->keysTemp);
+        this->order.swap(this->orderTemp);
+    }
+}
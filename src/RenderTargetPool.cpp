@@ -0,0 +1,64 @@
+#include <iostream>
+#include "RenderTargetPool.h"
+#include "GLState.h"
+
+RenderTargetPool::~RenderTargetPool()
+{
+    this->Clear();
+}
+
+RenderTarget *RenderTargetPool::Acquire(unsigned int width, unsigned int height)
+{
+    for (RenderTarget *target : this->targets)
+    {
+        if (!target->InUse && target->Width == width && target->Height == height)
+        {
+            target->InUse = true;
+            return target;
+        }
+    }
+    RenderTarget *target = new RenderTarget();
+    target->Width = width;
+    target->Height = height;
+    target->InUse = true;
+    glGenFramebuffers(1, &target->FBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, target->FBO);
+    target->Texture.Generate(width, height, NULL);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target->Texture.ID, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE){
+        std::cout << "ERROR::RENDERTARGETPOOL: Failed to initialize FBO" << std::endl;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    this->targets.push_back(target);
+    return target;
+}
+
+void RenderTargetPool::Release(RenderTarget *target)
+{
+    if (target)
+        target->InUse = false;
+}
+
+void RenderTargetPool::Clear()
+{
+    for (RenderTarget *target : this->targets)
+    {
+        glDeleteFramebuffers(1, &target->FBO);
+        GLState::DeleteTexture(target->Texture.ID);
+        delete target;
+    }
+    this->targets.clear();
+}
+
+unsigned int RenderTargetPool::Size() const
+{
+    return this->targets.size();
+}
+
+size_t RenderTargetPool::TextureBytes() const
+{
+    size_t bytes = 0;
+    for (const RenderTarget *target : this->targets)
+        bytes += 4 * static_cast<size_t>(target->Width) * target->Height;
+    return bytes;
+}
@@ -0,0 +1,128 @@
+#include "ResolutionController.h"
+
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <cstdio>
+
+// smoothing factor of the frame time averages
+static const float TIME_SMOOTHING = 0.1f;
+// frames to wait after a change so the averages reflect the new settings
+static const unsigned int CHANGE_COOLDOWN = 30;
+// number of changes kept
+static const unsigned int HISTORY_SIZE = 32;
+// fractions of the budget that trigger a decrease and an increase
+static const float OVER_BUDGET = 0.95f, UNDER_BUDGET = 0.7f;
+
+ResolutionController::ResolutionController(float budgetMilliseconds, unsigned int maxSamples)
+    : BudgetMilliseconds(budgetMilliseconds), MinScale(0.5f), MaxScale(1.0f), ScaleStep(0.1f), MaxSamples(maxSamples),
+      Scale(1.0f), Samples(maxSamples), CPUMilliseconds(0.0f), GPUMilliseconds(0.0f),
+      LastCPUMilliseconds(0.0f), LastGPUMilliseconds(0.0f),
+      frame(0), cooldown(CHANGE_COOLDOWN), cpuBound(false), frameStart(0.0)
+{
+    glGenQueries(RESOLUTION_TIMER_QUERIES, this->queries);
+}
+
+ResolutionController::~ResolutionController()
+{
+    glDeleteQueries(RESOLUTION_TIMER_QUERIES, this->queries);
+}
+
+void ResolutionController::BeginFrame()
+{
+    this->frameStart = glfwGetTime();
+    glBeginQuery(GL_TIME_ELAPSED, this->queries[this->frame % RESOLUTION_TIMER_QUERIES]);
+}
+
+void ResolutionController::EndFrame()
+{
+    glEndQuery(GL_TIME_ELAPSED);
+    float cpu = static_cast<float>((glfwGetTime() - this->frameStart) * 1000.0);
+    this->LastCPUMilliseconds = cpu;
+    this->CPUMilliseconds += (cpu - this->CPUMilliseconds) * TIME_SMOOTHING;
+    this->frame++;
+    this->collectGPUTime();
+
+    if (this->cooldown > 0)
+    {
+        this->cooldown--;
+        return;
+    }
+    char reason[128];
+    float budget = this->BudgetMilliseconds;
+    // only the GPU side scales with the pixel count
+    bool cpuBound = this->CPUMilliseconds > budget * OVER_BUDGET && this->GPUMilliseconds < budget * OVER_BUDGET;
+    if (cpuBound != this->cpuBound)
+    {
+        this->cpuBound = cpuBound;
+        std::snprintf(reason, sizeof(reason), cpuBound ? "cpu %.1f ms over %.1f ms budget, resolution kept" : "no longer cpu bound (cpu %.1f ms, budget %.1f ms)",
+            this->CPUMilliseconds, budget);
+        this->record(reason);
+    }
+    if (this->GPUMilliseconds > budget * OVER_BUDGET)
+    {
+        // multisampling goes first, it costs the most per pixel of visible quality
+        if (this->Samples > 1)
+        {
+            unsigned int samples = this->Samples / 2;
+            std::snprintf(reason, sizeof(reason), "gpu %.1f ms over %.1f ms budget: msaa %ux -> %ux", this->GPUMilliseconds, budget, this->Samples, samples);
+            this->Samples = std::max(1u, samples);
+            this->record(reason);
+        }
+        else if (this->Scale > this->MinScale)
+        {
+            float scale = std::max(this->MinScale, this->Scale - this->ScaleStep);
+            std::snprintf(reason, sizeof(reason), "gpu %.1f ms over %.1f ms budget: scale %.2f -> %.2f", this->GPUMilliseconds, budget, this->Scale, scale);
+            this->Scale = scale;
+            this->record(reason);
+        }
+    }
+    else if (this->GPUMilliseconds < budget * UNDER_BUDGET)
+    {
+        if (this->Scale < this->MaxScale)
+        {
+            float scale = std::min(this->MaxScale, this->Scale + this->ScaleStep);
+            std::snprintf(reason, sizeof(reason), "gpu %.1f ms under %.1f ms budget: scale %.2f -> %.2f", this->GPUMilliseconds, budget, this->Scale, scale);
+            this->Scale = scale;
+            this->record(reason);
+        }
+        else if (this->Samples < this->MaxSamples)
+        {
+            unsigned int samples = std::min(this->MaxSamples, this->Samples * 2);
+            std::snprintf(reason, sizeof(reason), "gpu %.1f ms under %.1f ms budget: msaa %ux -> %ux", this->GPUMilliseconds, budget, this->Samples, samples);
+            this->Samples = samples;
+            this->record(reason);
+        }
+    }
+}
+
+const std::deque<ResolutionChange> &ResolutionController::History() const
+{
+    return this->history;
+}
+
+void ResolutionController::collectGPUTime()
+{
+    // the oldest query was issued RESOLUTION_TIMER_QUERIES - 1 frames ago
+    if (this->frame < RESOLUTION_TIMER_QUERIES)
+        return;
+    unsigned int query = this->queries[this->frame % RESOLUTION_TIMER_QUERIES];
+    GLint available = 0;
+    glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+        return;
+    GLuint64 nanoseconds = 0;
+    glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+    float gpu = static_cast<float>(nanoseconds / 1.0e6);
+    this->LastGPUMilliseconds = gpu;
+    this->GPUMilliseconds += (gpu - this->GPUMilliseconds) * TIME_SMOOTHING;
+}
+
+void ResolutionController::record(const std::string &reason)
+{
+    // any recorded change restarts the cooldown
+    this->cooldown = CHANGE_COOLDOWN;
+    this->history.push_back({ glfwGetTime(), this->Scale, this->Samples, this->CPUMilliseconds, this->GPUMilliseconds, reason });
+    if (this->history.size() > HISTORY_SIZE)
+        this->history.pop_front();
+}
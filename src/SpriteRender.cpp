@@ -1,71 +1,139 @@
 #include "SpriteRenderer.h"
+#include "GLState.h"
 
-SpriteRenderer::SpriteRenderer(Shader &shader) {
+
+SpriteRenderer::SpriteRenderer(Shader &shader)
+    : DrawCalls(0), SpritesDrawn(0), batchTexture(0), batching(false) {
     this->shader = shader;
     this->initRenderData();
 }
 
 SpriteRenderer::~SpriteRenderer() {
-    glDeleteVertexArrays(1, &this->quadVAO);
+    GLState::DeleteVertexArray(this->quadVAO);
+    delete this->stream;
 }
 
-void SpriteRenderer::DrawSprite(Texture2D &texture, glm::vec2 position,
-                    glm::vec2 size, 
-                    float rotate, 
+void SpriteRenderer::DrawSprite(const SubTexture &sprite, glm::vec2 position,
+                    glm::vec2 size,
+                    float rotate,
                     glm::vec3 color) {
+    this->Submit(sprite, position, size, rotate, color);
+    // outside of a batch every sprite is drawn immediately
+    if (!this->batching)
+        this->Flush();
+}
+
+void SpriteRenderer::Begin() {
+    this->batching = true;
+}
+
+void SpriteRenderer::Submit(const SubTexture &sprite, glm::vec2 position,
+                    glm::vec2 size,
+                    float rotate,
+                    glm::vec3 color) {
+    // a batch can only sample a single texture (atlas regions of the same texture share one)
+    if (!this->transforms.empty() && (sprite.Texture.ID != this->batchTexture || this->transforms.size() >= MAX_BATCH_SPRITES))
+        this->Flush();
+    this->batchTexture = sprite.Texture.ID;
+
+    this->transforms.push_back({ position, size, rotate });
+    this->regions.push_back(glm::vec4(sprite.UVOrigin, sprite.UVSize));
+    this->colors.push_back(glm::vec4(color, 1.0f));
+}
+
+void SpriteRenderer::Flush() {
+    if (this->transforms.empty())
+        return;
+
     this->shader.Use();
 
-    glm::mat4 model = glm::mat4(1.0f);
+    GLState::ActiveTexture(GL_TEXTURE0);
+    GLState::BindTexture(this->batchTexture);
 
-    // first translate 
-    model = glm::translate(model, glm::vec3(position, 0.0f));  
-    // move origin of rotation to center of quad
-    model = glm::translate(model, glm::vec3(0.5f * size.x, 0.5f * size.y, 0.0f)); 
-    // then rotate
-    model = glm::rotate(model, glm::radians(rotate), glm::vec3(0.0f, 0.0f, 1.0f)); 
-    // move origin back
-    model = glm::translate(model, glm::vec3(-0.5f * size.x, -0.5f * size.y, 0.0f)); 
-    // last scale
-    model = glm::scale(model, glm::vec3(size, 1.0f)); 
+    // transform the unit quads of the whole batch on the CPU so it shares one draw call; rotated sprites go four at a time with SSE
+    unsigned int count = this->transforms.size();
+    this->corners.resize(count * 4);
+    TransformSprites(this->transforms.data(), count, this->corners.data());
 
-    // model
-    this->shader.SetMatrix4("model", model);
-    // textured
-    this->shader.SetVector3f("spriteColor", color);
+    // stream the batch into the ring buffer; vertex offsets are multiples of the vertex size so they can be drawn with 'first'
+    unsigned int bytes = count * 6 * sizeof(SpriteVertex), offset;
+    SpriteVertex *data = static_cast<SpriteVertex*>(this->stream->Map(bytes, sizeof(SpriteVertex), offset));
+    if (data == nullptr)
+    {
+        // drop the batch; kept, it would keep growing past what Map can hand out and every later Flush would fail too
+        this->clearBatch();
+        return;
+    }
+    for (unsigned int i = 0; i < count; ++i, data += 6)
+    {
+        const glm::vec2 *quad = &this->corners[i * 4];
+        glm::vec2 uv0 = glm::vec2(this->regions[i]);
+        glm::vec2 uv1 = uv0 + glm::vec2(this->regions[i].z, this->regions[i].w);
+        const glm::vec4 &rgba = this->colors[i];
 
-    glActiveTexture(GL_TEXTURE0);
-    texture.Bind();
+        data[0] = { quad[2], glm::vec2(uv0.x, uv1.y), rgba };
+        data[1] = { quad[1], glm::vec2(uv1.x, uv0.y), rgba };
+        data[2] = { quad[0], uv0, rgba };
 
-    glBindVertexArray(this->quadVAO);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    glBindVertexArray(0);
+        data[3] = { quad[2], glm::vec2(uv0.x, uv1.y), rgba };
+        data[4] = { quad[3], uv1, rgba };
+        data[5] = { quad[1], glm::vec2(uv1.x, uv0.y), rgba };
+    }
+    this->stream->Unmap();
+
+    GLState::BindVertexArray(this->quadVAO);
+    glDrawArrays(GL_TRIANGLES, offset / sizeof(SpriteVertex), count * 6);
+
+    this->DrawCalls++;
+    this->SpritesDrawn += count;
+    this->clearBatch();
+}
 
+void SpriteRenderer::End() {
+    this->Flush();
+    this->batching = false;
+}
+
+void SpriteRenderer::EndFrame() {
+    this->stream->EndFrame();
+}
+
+const StreamBuffer &SpriteRenderer::GetStream() const {
+    return *this->stream;
+}
+
+void SpriteRenderer::ResetStats() {
+    this->DrawCalls = 0;
+    this->SpritesDrawn = 0;
 }
 
 void SpriteRenderer::initRenderData()
 {
-    // configure VAO/VBO
-    unsigned int VBO;
-    float vertices[] = { 
-        // pos      // tex
-        0.0f, 1.0f, 0.0f, 1.0f,
-        1.0f, 0.0f, 1.0f, 0.0f,
-        0.0f, 0.0f, 0.0f, 0.0f, 
-
-        0.0f, 1.0f, 0.0f, 1.0f,
-        1.0f, 1.0f, 1.0f, 1.0f,
-        1.0f, 0.0f, 1.0f, 0.0f
-    };
-
+    // configure VAO; vertices are streamed through a ring buffer with room for a few full batches per frame
     glGenVertexArrays(1, &this->quadVAO);
-    glGenBuffers(1, &VBO);
+    this->stream = new StreamBuffer(4 * MAX_BATCH_SPRITES * 6 * sizeof(SpriteVertex));
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, this->stream->ID);
 
-    glBindVertexArray(this->quadVAO);
+    GLState::BindVertexArray(this->quadVAO);
+    // pos + tex
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)0);
+    // color
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)offsetof(SpriteVertex, Color));
     glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
-}
\ No newline at end of file
+    GLState::BindVertexArray(0);
+
+    this->transforms.reserve(MAX_BATCH_SPRITES);
+    this->regions.reserve(MAX_BATCH_SPRITES);
+    this->colors.reserve(MAX_BATCH_SPRITES);
+    this->corners.reserve(MAX_BATCH_SPRITES * 4);
+}
+
+void SpriteRenderer::clearBatch()
+{
+    this->transforms.clear();
+    this->regions.clear();
+    this->colors.clear();
+}
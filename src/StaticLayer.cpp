@@ -0,0 +1,54 @@
+#include <iostream>
+#include "StaticLayer.h"
+#include "GLState.h"
+
+StaticLayer::StaticLayer(unsigned int width, unsigned int height)
+    : Texture(), Width(0), Height(0), viewport()
+{
+    glGenFramebuffers(1, &this->FBO);
+    this->Texture.Wrap_S = GL_CLAMP_TO_EDGE;
+    this->Texture.Wrap_T = GL_CLAMP_TO_EDGE;
+    this->Resize(width, height);
+}
+
+StaticLayer::~StaticLayer()
+{
+    glDeleteFramebuffers(1, &this->FBO);
+    GLState::DeleteTexture(this->Texture.ID);
+}
+
+void StaticLayer::Begin()
+{
+    glGetIntegerv(GL_VIEWPORT, this->viewport);
+    glBindFramebuffer(GL_FRAMEBUFFER, this->FBO);
+    glViewport(0, 0, this->Width, this->Height);
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+}
+
+void StaticLayer::End()
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(this->viewport[0], this->viewport[1], this->viewport[2], this->viewport[3]);
+}
+
+void StaticLayer::Resize(unsigned int width, unsigned int height)
+{
+    if (width == this->Width && height == this->Height)
+        return;
+    this->Width = width;
+    this->Height = height;
+    glBindFramebuffer(GL_FRAMEBUFFER, this->FBO);
+    this->Texture.Generate(width, height, NULL);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, this->Texture.ID, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE){
+        std::cout << "ERROR::STATICLAYER: Failed to initialize FBO" << std::endl;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+size_t StaticLayer::TextureBytes() const
+{
+    // RGB, padded to 4 bytes per texel
+    return 4 * static_cast<size_t>(this->Width) * this->Height;
+}
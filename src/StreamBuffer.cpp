@@ -0,0 +1,141 @@
+#include "StreamBuffer.h"
+
+#include <GLFW/glfw3.h>
+
+#include <iostream>
+
+// ARB_buffer_storage is not part of the GL 3.3 loader, fetch it ourselves
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+typedef void (APIENTRYP PFNGLBUFFERSTORAGEPROC)(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags);
+
+StreamBuffer::StreamBuffer(unsigned int segmentSize, unsigned int target)
+    : ID(0), Persistent(false), Stalls(0), Wraps(0), target(target), segmentSize(segmentSize), segment(0), head(0), mapped(nullptr), fences()
+{
+    unsigned int size = segmentSize * STREAM_BUFFER_SEGMENTS;
+    glGenBuffers(1, &this->ID);
+    glBindBuffer(this->target, this->ID);
+
+    PFNGLBUFFERSTORAGEPROC bufferStorage = nullptr;
+    if (glfwExtensionSupported("GL_ARB_buffer_storage"))
+        bufferStorage = (PFNGLBUFFERSTORAGEPROC)glfwGetProcAddress("glBufferStorage");
+    if (bufferStorage)
+    {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        bufferStorage(this->target, size, NULL, flags);
+        this->mapped = (char*)glMapBufferRange(this->target, 0, size, flags);
+        this->Persistent = this->mapped != nullptr;
+    }
+    if (!this->Persistent)
+    {
+        if (bufferStorage)
+        {
+            // immutable storage can't be orphaned, start over with a mutable buffer
+            glBindBuffer(this->target, 0);
+            glDeleteBuffers(1, &this->ID);
+            glGenBuffers(1, &this->ID);
+            glBindBuffer(this->target, this->ID);
+            std::cout << "WARNING::STREAMBUFFER: Persistent mapping failed, falling back to orphaning" << std::endl;
+        }
+        glBufferData(this->target, size, NULL, GL_STREAM_DRAW);
+    }
+    glBindBuffer(this->target, 0);
+}
+
+StreamBuffer::~StreamBuffer()
+{
+    for (unsigned int i = 0; i < STREAM_BUFFER_SEGMENTS; ++i)
+        if (this->fences[i])
+            glDeleteSync(this->fences[i]);
+    if (this->Persistent)
+    {
+        glBindBuffer(this->target, this->ID);
+        glUnmapBuffer(this->target);
+        glBindBuffer(this->target, 0);
+    }
+    glDeleteBuffers(1, &this->ID);
+}
+
+void *StreamBuffer::Map(unsigned int size, unsigned int alignment, unsigned int &offset)
+{
+    if (size > this->segmentSize)
+    {
+        std::cout << "ERROR::STREAMBUFFER: Allocation of " << size << " bytes exceeds segment size" << std::endl;
+        return nullptr;
+    }
+    unsigned int start = (this->head + alignment - 1) / alignment * alignment;
+    // doesn't fit in what's left of this frame's segment: continue in the next one
+    if (start + size > this->segmentSize)
+    {
+        this->advance();
+        start = 0;
+    }
+    this->head = start + size;
+    offset = this->segment * this->segmentSize + start;
+
+    if (this->Persistent)
+        return this->mapped + offset;
+
+    // fallback: this range hasn't been written since the last orphan, so nothing can be reading it
+    glBindBuffer(this->target, this->ID);
+    return glMapBufferRange(this->target, offset, size, GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+}
+
+void StreamBuffer::Unmap()
+{
+    // coherent persistent mappings are visible to the GPU without unmapping
+    if (this->Persistent)
+        return;
+    glBindBuffer(this->target, this->ID);
+    glUnmapBuffer(this->target);
+    glBindBuffer(this->target, 0);
+}
+
+void StreamBuffer::EndFrame()
+{
+    if (this->head > 0)
+        this->advance();
+}
+
+void StreamBuffer::advance()
+{
+    if (this->Persistent)
+    {
+        // release the segment we're leaving once the GPU is done with the commands issued so far
+        if (this->fences[this->segment])
+            glDeleteSync(this->fences[this->segment]);
+        this->fences[this->segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    this->segment = (this->segment + 1) % STREAM_BUFFER_SEGMENTS;
+    this->head = 0;
+    if (this->segment == 0)
+    {
+        this->Wraps++;
+        if (!this->Persistent)
+        {
+            // orphan: the driver hands us fresh storage while the GPU keeps reading the old one
+            glBindBuffer(this->target, this->ID);
+            glBufferData(this->target, this->segmentSize * STREAM_BUFFER_SEGMENTS, NULL, GL_STREAM_DRAW);
+            glBindBuffer(this->target, 0);
+        }
+    }
+
+    // make sure the GPU finished reading the segment we're about to overwrite
+    GLsync fence = this->fences[this->segment];
+    if (fence)
+    {
+        if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+        {
+            this->Stalls++;
+            while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED)
+                ;
+        }
+        glDeleteSync(fence);
+        this->fences[this->segment] = 0;
+    }
+}
@@ -0,0 +1,211 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#include "TextRenderer.h"
+#include "GLState.h"
+#include "TrueTypeFont.h"
+
+// number of layouts kept before the cache starts over
+static const unsigned int MAX_CACHED_LAYOUTS = 256;
+
+TextRenderer::TextRenderer(Shader shader)
+    : TextShader(shader), Atlas(), DrawCalls(0), ascent(0.0f)
+{
+    this->TextShader.SetInteger("text", 0, true);
+    // configure VAO; vertices are streamed like sprite batches
+    glGenVertexArrays(1, &this->VAO);
+    this->stream = new StreamBuffer(MAX_TEXT_GLYPHS * 6 * sizeof(SpriteVertex));
+    glBindBuffer(GL_ARRAY_BUFFER, this->stream->ID);
+    GLState::BindVertexArray(this->VAO);
+    // pos + tex
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)0);
+    // color
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)offsetof(SpriteVertex, Color));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GLState::BindVertexArray(0);
+    this->vertices.reserve(MAX_TEXT_GLYPHS * 6);
+}
+
+TextRenderer::~TextRenderer()
+{
+    GLState::DeleteVertexArray(this->VAO);
+    GLState::DeleteTexture(this->Atlas.ID);
+    delete this->stream;
+}
+
+void TextRenderer::Load(std::string font, unsigned int fontSize, float pixelScale)
+{
+    // first clear the previously loaded Characters
+    this->Characters.clear();
+    this->layouts.clear();
+    // then read the font file
+    TrueTypeFont face;
+    if (!face.Load(font))
+        return;
+    // the em is fontSize board units high, rasterized at pixelScale pixels per unit
+    float scale = face.ScaleForPixelHeight(std::floor(fontSize * pixelScale + 0.5f));
+
+    // rasterize the first 128 ASCII characters and shelf-pack them into one atlas row by row
+    struct Glyph { unsigned int x, y, width, height; std::vector<unsigned char> pixels; };
+    std::map<char, Glyph> glyphs;
+    const unsigned int padding = 1, atlasWidth = 512;
+    unsigned int x = padding, y = padding, rowHeight = 0;
+    for (unsigned char c = 32; c < 128; c++)
+    {
+        // rasterize character glyph
+        GlyphBitmap bitmap;
+        face.RenderGlyph(c, scale, bitmap);
+        Glyph glyph = { 0, 0, static_cast<unsigned int>(bitmap.Width), static_cast<unsigned int>(bitmap.Height), bitmap.Pixels };
+        if (x + glyph.width + padding > atlasWidth)
+        {
+            x = padding;
+            y += rowHeight + padding;
+            rowHeight = 0;
+        }
+        glyph.x = x;
+        glyph.y = y;
+        x += glyph.width + padding;
+        rowHeight = std::max(rowHeight, glyph.height);
+
+        // metrics in board units
+        Character character = {
+            glm::vec2(bitmap.Width, bitmap.Height) / pixelScale,
+            glm::vec2(bitmap.Left, bitmap.Top) / pixelScale,
+            bitmap.Advance / pixelScale,
+            glm::vec2(0.0f), glm::vec2(0.0f)
+        };
+        this->Characters.insert(std::pair<char, Character>(c, character));
+        glyphs.insert(std::pair<char, Glyph>(c, glyph));
+    }
+    unsigned int atlasHeight = 1;
+    while (atlasHeight < y + rowHeight + padding)
+        atlasHeight *= 2;
+
+    // copy the glyphs into the atlas and store their regions
+    std::vector<unsigned char> pixels(atlasWidth * atlasHeight, 0);
+    for (std::pair<const char, Glyph> &entry : glyphs)
+    {
+        Glyph &glyph = entry.second;
+        for (unsigned int row = 0; row < glyph.height; ++row)
+            std::memcpy(&pixels[(glyph.y + row) * atlasWidth + glyph.x], &glyph.pixels[row * glyph.width], glyph.width);
+        Character &character = this->Characters[entry.first];
+        character.UVOrigin = glm::vec2(static_cast<float>(glyph.x) / atlasWidth, static_cast<float>(glyph.y) / atlasHeight);
+        character.UVSize = glm::vec2(static_cast<float>(glyph.width) / atlasWidth, static_cast<float>(glyph.height) / atlasHeight);
+    }
+    // single channel texture; rows are tightly packed
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    this->Atlas.Internal_Format = GL_RED;
+    this->Atlas.Image_Format = GL_RED;
+    this->Atlas.Wrap_S = GL_CLAMP_TO_EDGE;
+    this->Atlas.Wrap_T = GL_CLAMP_TO_EDGE;
+    this->Atlas.Generate(atlasWidth, atlasHeight, pixels.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    // lines are positioned by their top; 'H' reaches the cap height
+    this->ascent = this->Characters['H'].Bearing.y;
+}
+
+void TextRenderer::RenderText(const std::string &text, float x, float y, float scale, glm::vec3 color, bool cache)
+{
+    if (!cache)
+        this->layOut(text, scale, this->scratch);
+    const TextLayout &layout = cache ? this->layout(text, scale) : this->scratch;
+    // the queue holds at most one frame's worth of glyphs
+    if (this->vertices.size() + layout.Quads.size() * 6 > MAX_TEXT_GLYPHS * 6)
+        return;
+    glm::vec4 rgba(color, 1.0f);
+    glm::vec2 origin(x, y);
+    for (unsigned int i = 0; i < layout.Quads.size(); ++i)
+    {
+        glm::vec2 p0 = origin + glm::vec2(layout.Quads[i]);
+        glm::vec2 p1 = p0 + glm::vec2(layout.Quads[i].z, layout.Quads[i].w);
+        glm::vec2 uv0 = glm::vec2(layout.UVs[i]);
+        glm::vec2 uv1 = uv0 + glm::vec2(layout.UVs[i].z, layout.UVs[i].w);
+
+        this->vertices.push_back({ glm::vec2(p0.x, p1.y), glm::vec2(uv0.x, uv1.y), rgba });
+        this->vertices.push_back({ glm::vec2(p1.x, p0.y), glm::vec2(uv1.x, uv0.y), rgba });
+        this->vertices.push_back({ p0, uv0, rgba });
+
+        this->vertices.push_back({ glm::vec2(p0.x, p1.y), glm::vec2(uv0.x, uv1.y), rgba });
+        this->vertices.push_back({ p1, uv1, rgba });
+        this->vertices.push_back({ glm::vec2(p1.x, p0.y), glm::vec2(uv1.x, uv0.y), rgba });
+    }
+}
+
+float TextRenderer::TextWidth(const std::string &text, float scale)
+{
+    return this->layout(text, scale).Width;
+}
+
+void TextRenderer::Flush()
+{
+    if (!this->vertices.empty())
+    {
+        unsigned int bytes = this->vertices.size() * sizeof(SpriteVertex), offset;
+        void *data = this->stream->Map(bytes, sizeof(SpriteVertex), offset);
+        if (data != nullptr)
+        {
+            std::memcpy(data, this->vertices.data(), bytes);
+            this->stream->Unmap();
+
+            this->TextShader.Use();
+            GLState::ActiveTexture(GL_TEXTURE0);
+            this->Atlas.Bind();
+            GLState::BindVertexArray(this->VAO);
+            glDrawArrays(GL_TRIANGLES, offset / sizeof(SpriteVertex), this->vertices.size());
+            this->DrawCalls++;
+        }
+        this->vertices.clear();
+    }
+    this->stream->EndFrame();
+}
+
+void TextRenderer::ResetStats()
+{
+    this->DrawCalls = 0;
+}
+
+const TextLayout &TextRenderer::layout(const std::string &text, float scale)
+{
+    std::string key = text;
+    key.push_back('\0');
+    key.append(reinterpret_cast<const char*>(&scale), sizeof(float));
+    std::unordered_map<std::string, TextLayout>::iterator it = this->layouts.find(key);
+    if (it != this->layouts.end())
+        return it->second;
+
+    // strings change rarely (scores, menus), a full cache means something is generating text every frame
+    if (this->layouts.size() >= MAX_CACHED_LAYOUTS)
+        this->layouts.clear();
+    TextLayout &layout = this->layouts[key];
+    this->layOut(text, scale, layout);
+    return layout;
+}
+
+void TextRenderer::layOut(const std::string &text, float scale, TextLayout &layout)
+{
+    layout.Quads.clear();
+    layout.UVs.clear();
+    float x = 0.0f;
+    for (char c : text)
+    {
+        std::map<char, Character>::const_iterator ch = this->Characters.find(c);
+        if (ch == this->Characters.end())
+            continue;
+        const Character &character = ch->second;
+        if (character.Size.x > 0.0f && character.Size.y > 0.0f)
+        {
+            float xpos = x + character.Bearing.x * scale;
+            float ypos = (this->ascent - character.Bearing.y) * scale;
+            layout.Quads.push_back(glm::vec4(xpos, ypos, character.Size * scale));
+            layout.UVs.push_back(glm::vec4(character.UVOrigin, character.UVSize));
+        }
+        // now advance cursors for next glyph
+        x += character.Advance * scale;
+    }
+    layout.Width = x;
+}
@@ -0,0 +1,407 @@
+#include "TrueTypeFont.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+// glyf point flags
+static const unsigned char ON_CURVE = 0x01, X_SHORT = 0x02, Y_SHORT = 0x04, REPEAT = 0x08, X_SAME = 0x10, Y_SAME = 0x20;
+// composite glyph flags
+static const unsigned int ARGS_ARE_WORDS = 0x0001, HAVE_SCALE = 0x0008, MORE_COMPONENTS = 0x0020, HAVE_XY_SCALE = 0x0040, HAVE_TWO_BY_TWO = 0x0080;
+// largest distance between a curve and the lines replacing it, in pixels
+static const float FLATNESS = 0.02f;
+// composite glyphs nest at most this deep
+static const int MAX_COMPOSITE_DEPTH = 8;
+
+// adds a line to the signed area accumulation buffer (rows of stride floats, y down); the
+// running sum along a row is then the coverage of each pixel
+static void accumulateLine(std::vector<float> &acc, int stride, int height, glm::vec2 p0, glm::vec2 p1)
+{
+    if (p0.y == p1.y)
+        return;
+    float direction = 1.0f;
+    if (p0.y > p1.y)
+    {
+        std::swap(p0, p1);
+        direction = -1.0f;
+    }
+    float dxdy = (p1.x - p0.x) / (p1.y - p0.y);
+    float limit = static_cast<float>(stride - 2);
+    int yBegin = std::max(0, static_cast<int>(std::floor(p0.y))), yEnd = std::min(height, static_cast<int>(std::ceil(p1.y)));
+    float x = p0.x + (std::max(p0.y, static_cast<float>(yBegin)) - p0.y) * dxdy;
+    for (int y = yBegin; y < yEnd; ++y)
+    {
+        float *row = &acc[y * stride];
+        float dy = std::min(y + 1.0f, p1.y) - std::max(static_cast<float>(y), p0.y);
+        float xNext = x + dxdy * dy;
+        float d = dy * direction;
+        float x0 = glm::clamp(std::min(x, xNext), 0.0f, limit), x1 = glm::clamp(std::max(x, xNext), 0.0f, limit);
+        float x0Floor = std::floor(x0), x1Ceil = std::ceil(x1);
+        int x0i = static_cast<int>(x0Floor), x1i = static_cast<int>(x1Ceil);
+        if (x1i <= x0i + 1)
+        {
+            // within one pixel: split by the mean x
+            float xm = 0.5f * (x0 + x1) - x0Floor;
+            row[x0i] += d - d * xm;
+            row[x0i + 1] += d * xm;
+        }
+        else
+        {
+            // across several pixels: the trapezoids left of the line, pixel by pixel
+            float s = 1.0f / (x1 - x0);
+            float x0f = x0 - x0Floor;
+            float a0 = 0.5f * s * (1.0f - x0f) * (1.0f - x0f);
+            float x1f = x1 - x1Ceil + 1.0f;
+            float am = 0.5f * s * x1f * x1f;
+            row[x0i] += d * a0;
+            if (x1i == x0i + 2)
+                row[x0i + 1] += d * (1.0f - a0 - am);
+            else
+            {
+                float a1 = s * (1.5f - x0f);
+                row[x0i + 1] += d * (a1 - a0);
+                for (int xi = x0i + 2; xi < x1i - 1; ++xi)
+                    row[xi] += d * s;
+                float a2 = a1 + (x1i - x0i - 3) * s;
+                row[x1i - 1] += d * (1.0f - a2 - am);
+            }
+            row[x1i] += d * am;
+        }
+        x = xNext;
+    }
+}
+
+// appends a quadratic curve from the last point of the polyline
+static void flattenQuad(std::vector<glm::vec2> &line, glm::vec2 control, glm::vec2 end)
+{
+    glm::vec2 start = line.back();
+    // the flattening error of n lines is |start - 2 control + end| / (8 n^2)
+    float deviation = glm::length(start - 2.0f * control + end);
+    int steps = std::max(1, static_cast<int>(std::ceil(std::sqrt(deviation / (8.0f * FLATNESS)))));
+    for (int i = 1; i <= steps; ++i)
+    {
+        float t = static_cast<float>(i) / steps;
+        line.push_back((1.0f - t) * (1.0f - t) * start + 2.0f * (1.0f - t) * t * control + t * t * end);
+    }
+}
+
+TrueTypeFont::TrueTypeFont()
+    : cmap(0), glyf(0), loca(0), hmtx(0), unitsPerEm(0), glyphCount(0), horizontalMetrics(0), longOffsets(false)
+{
+}
+
+bool TrueTypeFont::Load(const std::string &file)
+{
+    std::ifstream stream(file, std::ios::binary);
+    if (!stream)
+    {
+        std::cout << "ERROR::TRUETYPE: Failed to read font file " << file << std::endl;
+        return false;
+    }
+    this->data.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    unsigned int version = this->u32(0);
+    if (version != 0x00010000 && version != 0x74727565) // 1.0 or 'true'; CFF outlines ('OTTO') aren't supported
+    {
+        std::cout << "ERROR::TRUETYPE: " << file << " has no TrueType outlines" << std::endl;
+        return false;
+    }
+    unsigned int head = this->table("head"), hhea = this->table("hhea"), maxp = this->table("maxp");
+    this->glyf = this->table("glyf");
+    this->loca = this->table("loca");
+    this->hmtx = this->table("hmtx");
+    unsigned int cmapTable = this->table("cmap");
+    if (!head || !hhea || !maxp || !this->glyf || !this->loca || !this->hmtx || !cmapTable)
+    {
+        std::cout << "ERROR::TRUETYPE: " << file << " lacks a required table" << std::endl;
+        return false;
+    }
+    this->unitsPerEm = this->u16(head + 18);
+    this->longOffsets = this->s16(head + 50) != 0;
+    this->glyphCount = this->u16(maxp + 4);
+    this->horizontalMetrics = this->u16(hhea + 34);
+
+    // a unicode character map in format 4 (segments of consecutive characters)
+    this->cmap = 0;
+    for (unsigned int i = 0, count = this->u16(cmapTable + 2); i < count && !this->cmap; ++i)
+    {
+        unsigned int record = cmapTable + 4 + 8 * i;
+        unsigned int platform = this->u16(record), encoding = this->u16(record + 2);
+        unsigned int subtable = cmapTable + this->u32(record + 4);
+        bool unicode = platform == 0 || (platform == 3 && encoding == 1);
+        if (unicode && this->u16(subtable) == 4)
+            this->cmap = subtable;
+    }
+    if (!this->cmap || this->unitsPerEm == 0 || this->horizontalMetrics == 0)
+    {
+        std::cout << "ERROR::TRUETYPE: " << file << " has no usable unicode character map" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+float TrueTypeFont::ScaleForPixelHeight(float pixels) const
+{
+    return this->unitsPerEm ? pixels / this->unitsPerEm : 0.0f;
+}
+
+void TrueTypeFont::RenderGlyph(unsigned int codepoint, float scale, GlyphBitmap &bitmap) const
+{
+    bitmap.Width = bitmap.Height = bitmap.Left = bitmap.Top = 0;
+    bitmap.Advance = 0.0f;
+    bitmap.Pixels.clear();
+    if (this->data.empty())
+        return;
+    unsigned int glyph = this->glyphIndex(codepoint);
+    unsigned int metric = std::min(glyph, this->horizontalMetrics - 1);
+    // whole pixel advances keep the glyphs of a string on the pixel grid
+    bitmap.Advance = std::round(this->u16(this->hmtx + 4 * metric) * scale);
+
+    std::vector< std::vector<glm::vec2> > contours;
+    this->outline(glyph, glm::mat2(scale), glm::vec2(0.0f), contours, 0);
+    glm::vec2 lo(1e9f), hi(-1e9f);
+    for (const std::vector<glm::vec2> &contour : contours)
+        for (const glm::vec2 &point : contour)
+        {
+            lo = glm::min(lo, point);
+            hi = glm::max(hi, point);
+        }
+    if (lo.x > hi.x)
+        return;
+    bitmap.Left = static_cast<int>(std::floor(lo.x));
+    bitmap.Top = static_cast<int>(std::ceil(hi.y));
+    bitmap.Width = static_cast<int>(std::ceil(hi.x)) - bitmap.Left;
+    bitmap.Height = bitmap.Top - static_cast<int>(std::floor(lo.y));
+    if (bitmap.Width <= 0 || bitmap.Height <= 0)
+    {
+        bitmap.Width = bitmap.Height = 0;
+        return;
+    }
+
+    // two spare columns take the area right of lines on the last pixel edge
+    int stride = bitmap.Width + 2;
+    std::vector<float> acc(stride * bitmap.Height, 0.0f);
+    glm::vec2 origin(static_cast<float>(bitmap.Left), static_cast<float>(bitmap.Top));
+    for (const std::vector<glm::vec2> &contour : contours)
+        for (unsigned int i = 0; i + 1 < contour.size(); ++i)
+        {
+            glm::vec2 p0 = contour[i] - origin, p1 = contour[i + 1] - origin;
+            accumulateLine(acc, stride, bitmap.Height, glm::vec2(p0.x, -p0.y), glm::vec2(p1.x, -p1.y));
+        }
+    bitmap.Pixels.resize(bitmap.Width * bitmap.Height);
+    for (int y = 0; y < bitmap.Height; ++y)
+    {
+        float coverage = 0.0f;
+        for (int x = 0; x < bitmap.Width; ++x)
+        {
+            coverage += acc[y * stride + x];
+            bitmap.Pixels[y * bitmap.Width + x] = static_cast<unsigned char>(std::min(std::abs(coverage), 1.0f) * 255.0f + 0.5f);
+        }
+    }
+}
+
+unsigned int TrueTypeFont::u16(unsigned int offset) const
+{
+    if (offset + 2 > this->data.size())
+        return 0;
+    return (this->data[offset] << 8) | this->data[offset + 1];
+}
+
+int TrueTypeFont::s16(unsigned int offset) const
+{
+    return static_cast<short>(this->u16(offset));
+}
+
+unsigned int TrueTypeFont::u32(unsigned int offset) const
+{
+    return (this->u16(offset) << 16) | this->u16(offset + 2);
+}
+
+unsigned int TrueTypeFont::table(const char *tag) const
+{
+    for (unsigned int i = 0, count = this->u16(4); i < count; ++i)
+    {
+        unsigned int record = 12 + 16 * i;
+        if (record + 16 <= this->data.size() && std::memcmp(&this->data[record], tag, 4) == 0)
+            return this->u32(record + 8);
+    }
+    return 0;
+}
+
+unsigned int TrueTypeFont::glyphIndex(unsigned int codepoint) const
+{
+    if (codepoint > 0xFFFF)
+        return 0;
+    unsigned int segments = this->u16(this->cmap + 6) / 2;
+    unsigned int ends = this->cmap + 14, starts = ends + 2 * segments + 2;
+    unsigned int deltas = starts + 2 * segments, ranges = deltas + 2 * segments;
+    for (unsigned int i = 0; i < segments; ++i)
+    {
+        if (this->u16(ends + 2 * i) < codepoint)
+            continue;
+        unsigned int start = this->u16(starts + 2 * i);
+        if (start > codepoint)
+            return 0;
+        unsigned int delta = this->u16(deltas + 2 * i), range = this->u16(ranges + 2 * i);
+        if (range == 0)
+            return (codepoint + delta) & 0xFFFF;
+        // the range offset is relative to its own position in the table
+        unsigned int glyph = this->u16(ranges + 2 * i + range + 2 * (codepoint - start));
+        return glyph ? (glyph + delta) & 0xFFFF : 0;
+    }
+    return 0;
+}
+
+void TrueTypeFont::outline(unsigned int glyph, const glm::mat2 &matrix, glm::vec2 offset, std::vector< std::vector<glm::vec2> > &contours, int depth) const
+{
+    if (glyph >= this->glyphCount || depth > MAX_COMPOSITE_DEPTH)
+        return;
+    unsigned int begin = this->longOffsets ? this->u32(this->loca + 4 * glyph) : 2 * this->u16(this->loca + 2 * glyph);
+    unsigned int end = this->longOffsets ? this->u32(this->loca + 4 * glyph + 4) : 2 * this->u16(this->loca + 2 * glyph + 2);
+    if (end <= begin)
+        return; // no outline, e.g. a space
+    unsigned int at = this->glyf + begin;
+    int contourCount = this->s16(at);
+
+    if (contourCount < 0)
+    {
+        // composite: other glyphs, each placed with its own transform
+        unsigned int p = at + 10, flags;
+        do
+        {
+            flags = this->u16(p);
+            unsigned int component = this->u16(p + 2);
+            p += 4;
+            glm::vec2 shift;
+            if (flags & ARGS_ARE_WORDS)
+            {
+                shift = glm::vec2(this->s16(p), this->s16(p + 2));
+                p += 4;
+            }
+            else
+            {
+                shift = glm::vec2(static_cast<signed char>(this->data[p]), static_cast<signed char>(this->data[p + 1]));
+                p += 2;
+            }
+            // 2.14 fixed point; glm matrices are column major
+            glm::mat2 transform(1.0f);
+            if (flags & HAVE_SCALE)
+            {
+                transform = glm::mat2(this->s16(p) / 16384.0f);
+                p += 2;
+            }
+            else if (flags & HAVE_XY_SCALE)
+            {
+                transform = glm::mat2(this->s16(p) / 16384.0f, 0.0f, 0.0f, this->s16(p + 2) / 16384.0f);
+                p += 4;
+            }
+            else if (flags & HAVE_TWO_BY_TWO)
+            {
+                transform = glm::mat2(this->s16(p) / 16384.0f, this->s16(p + 2) / 16384.0f, this->s16(p + 4) / 16384.0f, this->s16(p + 6) / 16384.0f);
+                p += 8;
+            }
+            this->outline(component, matrix * transform, offset + matrix * shift, contours, depth + 1);
+        } while (flags & MORE_COMPONENTS);
+        return;
+    }
+
+    // simple glyph: contour end points, instructions (skipped), flags, then x and y deltas
+    unsigned int p = at + 10;
+    std::vector<unsigned int> contourEnds(contourCount);
+    for (int i = 0; i < contourCount; ++i)
+        contourEnds[i] = this->u16(p + 2 * i);
+    p += 2 * contourCount;
+    unsigned int pointCount = contourCount > 0 ? contourEnds.back() + 1 : 0;
+    p += 2 + this->u16(p);
+    std::vector<unsigned char> flags(pointCount);
+    for (unsigned int i = 0; i < pointCount && p < this->data.size(); ++i)
+    {
+        flags[i] = this->data[p++];
+        if ((flags[i] & REPEAT) && p < this->data.size())
+            for (unsigned int repeat = this->data[p++]; repeat > 0 && i + 1 < pointCount; --repeat)
+            {
+                flags[i + 1] = flags[i];
+                ++i;
+            }
+    }
+    std::vector<glm::vec2> points(pointCount);
+    for (int axis = 0; axis < 2; ++axis)
+    {
+        unsigned char isShort = axis == 0 ? X_SHORT : Y_SHORT, same = axis == 0 ? X_SAME : Y_SAME;
+        int value = 0;
+        for (unsigned int i = 0; i < pointCount; ++i)
+        {
+            if (flags[i] & isShort)
+            {
+                int delta = p < this->data.size() ? this->data[p] : 0;
+                value += (flags[i] & same) ? delta : -delta;
+                p += 1;
+            }
+            else if (!(flags[i] & same))
+            {
+                value += this->s16(p);
+                p += 2;
+            }
+            points[i][axis] = static_cast<float>(value);
+        }
+    }
+    for (glm::vec2 &point : points)
+        point = matrix * point + offset;
+
+    // off-curve points are quadratic controls; two in a row imply an on-curve point halfway between them
+    unsigned int first = 0;
+    for (int c = 0; c < contourCount; ++c)
+    {
+        unsigned int last = contourEnds[c];
+        if (last < first || last >= pointCount)
+            break;
+        unsigned int count = last - first + 1;
+        const glm::vec2 *pt = &points[first];
+        const unsigned char *fl = &flags[first];
+        // start on an on-curve point, or between two controls if there is none at either end
+        glm::vec2 start;
+        unsigned int from = 0, to = count;
+        if (fl[0] & ON_CURVE)
+        {
+            start = pt[0];
+            from = 1;
+        }
+        else if (fl[count - 1] & ON_CURVE)
+        {
+            start = pt[count - 1];
+            to = count - 1;
+        }
+        else
+            start = 0.5f * (pt[0] + pt[count - 1]);
+
+        std::vector<glm::vec2> line(1, start);
+        bool haveControl = false;
+        glm::vec2 control;
+        for (unsigned int i = from; i < to; ++i)
+        {
+            if (fl[i] & ON_CURVE)
+            {
+                if (haveControl)
+                    flattenQuad(line, control, pt[i]);
+                else
+                    line.push_back(pt[i]);
+                haveControl = false;
+            }
+            else
+            {
+                if (haveControl)
+                    flattenQuad(line, control, 0.5f * (control + pt[i]));
+                control = pt[i];
+                haveControl = true;
+            }
+        }
+        if (haveControl)
+            flattenQuad(line, control, start);
+        else
+            line.push_back(start);
+        contours.push_back(line);
+        first = last + 1;
+    }
+}
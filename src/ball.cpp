@@ -42,6 +42,8 @@ glm::vec2 Ball::Move(float dt, unsigned int window_width)
 void Ball::Reset(glm::vec2 position, glm::vec2 velocity)
 {
     this->Position = position;
+    // no blending across a reset
+    this->PrevPosition = position;
     this->Velocity = velocity;
     this->Stuck = true;
     this->Sticky = false;
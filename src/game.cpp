@@ -1,18 +1,37 @@
+#include <algorithm>
+#include <cstdlib>
+
 #include "game.h"
 #include "resource_manager.hpp"
 #include "SpriteRenderer.h"
 #include "shader.h"
 #include "ball.h"
 #include "PostProcessor.h"
+#include "GLState.h"
+#include "FrameUniforms.h"
+#include "StaticLayer.h"
+#include "RenderQueue.h"
+#include "ResolutionController.h"
+#include "TextRenderer.h"
+#include "PerfOverlay.h"
+#include "SweptCollision.h"
 
 SpriteRenderer *renderer;
 GameObject *player;
 Ball *ball; 
-ParticleGenerator *particles;
+ParticleSystem *particles;
 PostProcessor   *effects;
+FrameUniforms   *frame;
+StaticLayer     *background;
+RenderQueue     *queue;
+ResolutionController *resolution;
+TextRenderer    *text;
+PerfOverlay     *perf;
+// level the static layer was last built for (-1 forces a rebuild)
+int backgroundLevel = -1;
 float ShakeTime = 0.0f;
 
-Game::Game(unsigned int width, unsigned int height): State(GAME_ACTIVE), Keys(), Width(width), Height(height){}
+Game::Game(unsigned int width, unsigned int height): State(GAME_MENU), Keys(), KeysProcessed(), Width(width), Height(height), FramebufferWidth(width), FramebufferHeight(height), Lives(3), Score(0), ContinuousCollisions(true){}
 
 Game::~Game() {
     delete renderer;
@@ -20,27 +39,42 @@ Game::~Game() {
     delete ball;
     delete particles;
     delete effects;
+    delete frame;
+    delete background;
+    delete queue;
+    delete resolution;
+    delete text;
+    delete perf;
 }
 
 void Game::Init() {
     // load shaders
     ResourceManager::LoadShader("shaders/sprite.vs", "shaders/sprite.frag", nullptr, "sprite");
     ResourceManager::LoadShader("shaders/particle.vs", "shaders/particle.frag", nullptr, "particle");
-    ResourceManager::LoadShader("shaders/post_processing.vs", "shaders/post_processing.frag", nullptr, "postprocessing");
+    ResourceManager::LoadShader("shaders/post.vs", "shaders/post_blur.frag", nullptr, "post_blur");
+    ResourceManager::LoadShader("shaders/post.vs", "shaders/post_edge.frag", nullptr, "post_edge");
+    ResourceManager::LoadShader("shaders/post.vs", "shaders/post_invert.frag", nullptr, "post_invert");
+    ResourceManager::LoadShader("shaders/post.vs", "shaders/post_copy.frag", nullptr, "post_copy");
+    ResourceManager::LoadShader("shaders/brick.vs", "shaders/sprite.frag", nullptr, "brick");
+    ResourceManager::LoadShader("shaders/blit.vs", "shaders/blit.frag", nullptr, "blit");
+    ResourceManager::LoadShader("shaders/text_2d.vs", "shaders/text_2d.frag", nullptr, "text");
     
-    // configure shaders
-    glm::mat4 projection = glm::ortho(0.0f, static_cast<float>(this->Width), 
-        static_cast<float>(this->Height), 0.0f, -1.0f, 1.0f);
+    // configure shaders; the projection and other per-frame constants are shared through one uniform buffer
+    frame = new FrameUniforms();
+    for (auto &shader : ResourceManager::Shaders)
+        frame->Attach(shader.second);
     
     ResourceManager::GetShader("sprite").Use().SetInteger("image", 0);
-    ResourceManager::GetShader("sprite").SetMatrix4("projection", projection);
     ResourceManager::GetShader("particle").Use().SetInteger("sprite", 0);
-    ResourceManager::GetShader("particle").Use().SetMatrix4("projection", projection);
+    ResourceManager::GetShader("brick").Use().SetInteger("image", 0);
 
     // set render-specific controls
     Shader myShader;
     myShader = ResourceManager::GetShader("sprite");
     renderer = new SpriteRenderer(myShader);
+    // the glyph atlas is rasterized at the framebuffer's pixel density
+    text = new TextRenderer(ResourceManager::GetShader("text"));
+    text->Load("fonts/DejaVuSansMono-Bold.ttf", 24, static_cast<float>(this->FramebufferWidth) / this->Width);
 
     // load textures
     ResourceManager::LoadTexture("textures/background.jpg", true, "background");
@@ -56,6 +90,9 @@ void Game::Init() {
     ResourceManager::LoadTexture("textures/powerup_confuse.png", true, "powerup_confuse");
     ResourceManager::LoadTexture("textures/powerup_chaos.png", true, "powerup_chaos");
     ResourceManager::LoadTexture("textures/powerup_passthrough.png", true, "powerup_passthrough");
+    // pack bricks, paddle and power-ups into one atlas so they can share a texture bind
+    ResourceManager::PackAtlas({ "block", "block_solid", "paddle",
+        "powerup_speed", "powerup_sticky", "powerup_increase", "powerup_confuse", "powerup_chaos", "powerup_passthrough" }, "sprites");
 
     // load levels
     // 4 levels:
@@ -64,50 +101,87 @@ void Game::Init() {
     // Space invader
     // Bounce galore
 
-    GameLevel one; 
-    one.Load("levels/one.lvl", this->Width, this->Height/2);
-
-    GameLevel two; 
-    two.Load("levels/two.lvl", this->Width, this->Height/2);
-
-    GameLevel three; 
-    three.Load("levels/three.lvl", this->Width, this->Height/2);
-
-    GameLevel four; 
-    four.Load("levels/four.lvl", this->Width, this->Height/2);
-
-    this->Levels.push_back(one);
-    this->Levels.push_back(two);
-    this->Levels.push_back(three);
-    this->Levels.push_back(four);
+    // levels own GL objects and can't be copied, so they are loaded in place
+    const char *levelFiles[] = { "levels/one.lvl", "levels/two.lvl", "levels/three.lvl", "levels/four.lvl" };
+    this->Levels.reserve(4);
+    for (const char *file : levelFiles)
+    {
+        this->Levels.emplace_back();
+        this->Levels.back().Load(file, this->Width, this->Height/2);
+    }
     this->Level = 0; // set to the first level initially
 
     // configure game objects
     glm::vec2 playerPos = glm::vec2(this->Width / 2.0f - PLAYER_SIZE.x / 2.0f, this->Height - PLAYER_SIZE.y);
-    player = new GameObject(playerPos, PLAYER_SIZE, ResourceManager::GetTexture("paddle"), glm::vec3(0.49f, 0.188f, 0.188f));
+    player = new GameObject(playerPos, PLAYER_SIZE, ResourceManager::GetSubTexture("paddle"), glm::vec3(0.49f, 0.188f, 0.188f));
 
     // configure ball objects
     glm::vec2 ballPos = playerPos + glm::vec2(PLAYER_SIZE.x / 2.0f - BALL_RADIUS, -BALL_RADIUS * 2.0f);
     ball = new Ball(ballPos, BALL_RADIUS, INITIAL_BALL_VELOCITY, ResourceManager::GetTexture("face"));
 
-    particles = new ParticleGenerator(
-        ResourceManager::GetShader("particle"), 
-        ResourceManager::GetTexture("particle"), 
-        500
-    );
+    // BREAKOUT_GPU_PARTICLES=1 simulates the particles with transform feedback instead of on the CPU
+    const char *gpuParticles = std::getenv("BREAKOUT_GPU_PARTICLES");
+    ParticleGenerator *generator;
+    if (gpuParticles != nullptr && std::string(gpuParticles) != "0")
+        generator = new ParticleGenerator(
+            ResourceManager::GetShader("particle"),
+            ResourceManager::LoadFeedbackShader("shaders/particle_update.vs", { "outPosition", "outVelocity", "outColor", "outLife" }, "particle_update"),
+            ResourceManager::GetTexture("particle"),
+            PARTICLE_BUDGET
+        );
+    else
+        generator = new ParticleGenerator(
+            ResourceManager::GetShader("particle"), 
+            ResourceManager::GetTexture("particle"), 
+            PARTICLE_BUDGET
+        );
+    // all emitters share the generator's pool and draw call
+    particles = new ParticleSystem(generator, PARTICLE_BUDGET);
+    ParticleEmitter trail;
+    trail.Follow = ball;
+    trail.Offset = glm::vec2(ball->Radius / 2.0f);
+    trail.Rate = 120.0f;
+    particles->AddEmitter(trail);
+
+    // render targets match the framebuffer's pixels, not the board size
+    effects = new PostProcessor(ResourceManager::GetShader("blit"), this->FramebufferWidth, this->FramebufferHeight);
+    // post-processing chain, in order; the game's effects switch these passes on and off
+    effects->AddPass("blur", ResourceManager::GetShader("post_blur"), true, 1);
+    unsigned int edge = effects->AddPass("edge", ResourceManager::GetShader("post_edge"));
+    unsigned int invert = effects->AddPass("invert", ResourceManager::GetShader("post_invert"));
+    unsigned int shake = effects->AddPass("shake", ResourceManager::GetShader("post_copy"));
+    effects->Passes[edge].Swirl = 0.3f;
+    effects->Passes[invert].UVScale = glm::vec2(-1.0f);
+    effects->Passes[invert].UVOffset = glm::vec2(1.0f);
+    effects->Passes[shake].Jitter = 0.01f;
+    background = new StaticLayer(effects->Width, effects->Height);
+    queue = new RenderQueue();
+    // holds 60 fps by trading MSAA samples and internal resolution
+    resolution = new ResolutionController(1000.0f / 60.0f, effects->Samples);
+    perf = new PerfOverlay(resolution->BudgetMilliseconds);
 
-    effects = new PostProcessor(ResourceManager::GetShader("postprocessing"), this->Width*2, this->Height*2); // need to double
+    glm::mat4 projection = glm::ortho(0.0f, static_cast<float>(this->Width), 
+        static_cast<float>(this->Height), 0.0f, -1.0f, 1.0f);
+    frame->SetView(projection, effects->Width, effects->Height);
+    frame->Upload();
 
 }
 
 void Game::Update(float dt) {
-    // update objects
-    ball->Move(dt, this->Width);
+    // update objects; the continuous mode moves the ball and resolves its collisions in one go
+    if (this->ContinuousCollisions)
+        this->SweepBall(dt);
+    else
+    {
+        glm::vec2 ballStart = ball->Position;
+        ball->Move(dt, this->Width);
         
-    // check for collisions
-    this->DoCollisions();
+        // check for collisions
+        this->DoCollisions(ballStart);
+    }
+    this->DoPowerUpCollisions();
 
-    particles->Update(dt, *ball, 2, glm::vec2(ball->Radius / 2.0f));
+    particles->Update(dt);
 
     if (ShakeTime > 0.0f){
         ShakeTime -= dt;
@@ -138,6 +212,12 @@ void Game::Update(float dt) {
 }
 
 void Game::ProcessInput(float dt) {
+    // F3 toggles the performance overlay in every state
+    if (this->Keys[GLFW_KEY_F3] && !this->KeysProcessed[GLFW_KEY_F3])
+    {
+        perf->Visible = !perf->Visible;
+        this->KeysProcessed[GLFW_KEY_F3] = true;
+    }
 
     if (this->State == GAME_MENU)
     {
@@ -200,53 +280,133 @@ void Game::ProcessInput(float dt) {
 
 }
 
-void Game::Render() {
+void Game::SavePositions() {
+    // where the moving objects start the tick; Render blends from here to where the tick leaves them
+    ball->PrevPosition = ball->Position;
+    player->PrevPosition = player->Position;
+    for (PowerUp &powerUp : this->PowerUps)
+        powerUp.PrevPosition = powerUp.Position;
+}
+
+void Game::Render(float alpha) {
     // Texture2D myTexture;
     // myTexture = ResourceManager::GetTexture("face");
     // renderer->DrawSprite(myTexture, glm::vec2(200.0f, 200.0f), glm::vec2(300.0f, 400.0f), 45.0f, glm::vec3(0.0f, 1.0f, 0.0f));
 
     if(this->State == GAME_ACTIVE || this->State == GAME_MENU || this->State == GAME_WIN)
     {   
-        effects->BeginRender();
-
-            // draw background
-            Texture2D bgTexture;
-            bgTexture = ResourceManager::GetTexture("background");
-            renderer->DrawSprite(bgTexture, glm::vec2(0.0f, 0.0f), glm::vec2(this->Width, this->Height), 0.0f);
-
-            // draw level
-            this->Levels[this->Level].Draw(*renderer);
-
-            // draw player
-            player->Draw(*renderer);
-
-            // draw PowerUps
+        renderer->ResetStats();
+        this->Levels[this->Level].ResetStats();
+        particles->ResetStats();
+        effects->ResetStats();
+        text->ResetStats();
+        GLState::ResetFrameCounters();
+        resolution->BeginFrame();
+        effects->SetScale(resolution->Scale);
+        effects->SetSamples(resolution->Samples);
+
+        // background and solid bricks never change while a level is played; only redraw them into the static layer when the level changes
+        if (backgroundLevel != (int)this->Level)
+            this->BuildStaticLayer();
+
+        // chaos: edge detection on swirling coordinates, confuse: inverted and flipped, shake: blurred and jittering
+        effects->GetPass("blur")->Enabled = effects->Shake;
+        effects->GetPass("edge")->Enabled = effects->Chaos;
+        effects->GetPass("invert")->Enabled = effects->Confuse;
+        effects->GetPass("shake")->Enabled = effects->Shake;
+
+        effects->BeginRender(&background->Texture);
+
+            // queue the scene; layers keep the order that matters, inside a layer draws are grouped by state
+            GameLevel &level = this->Levels[this->Level];
+            // instanced bricks and particles are alone in their layers and draw themselves
+            queue->PushCallback(RenderQueue::MakeKey(LAYER_LEVEL, BLEND_ALPHA, 0, 0, 0), [&level]() { level.Draw(*renderer); });
+
+            // player and power-ups share the sprite atlas; depth keeps power-ups above the paddle
+            player->Draw(*queue, LAYER_OBJECTS, 0, alpha);
             for (PowerUp &powerUp : this->PowerUps){
                 if (!powerUp.Destroyed){
-                    powerUp.Draw(*renderer); 
+                    powerUp.Draw(*queue, LAYER_OBJECTS, 1, alpha); 
                 }  
             }
 
-            // draw particles	
-            particles->Draw();
+            queue->PushCallback(RenderQueue::MakeKey(LAYER_PARTICLES, BLEND_ADDITIVE, 0, 0, 0), []() { particles->Draw(); });
+
+            ball->Draw(*queue, LAYER_BALL, 0, alpha);
 
-            // draw ball
-            ball->Draw(*renderer);
+            queue->Submit(*renderer);
 
         effects->EndRender();
-        effects->Render(glfwGetTime());
+        // per-frame constants for the post-processing pass, uploaded in one go
+        frame->Data.Time = glfwGetTime();
+        frame->Data.Chaos = effects->Chaos;
+        frame->Data.Confuse = effects->Confuse;
+        frame->Data.Shake = effects->Shake;
+        frame->Upload();
+        effects->Render();
+
+        // text is drawn over the post-processed scene
+        std::string stage = "Level: " + std::to_string(this->Level + 1);
+        std::string score = "Score: " + std::to_string(this->Score);
+        text->RenderText("Lives: " + std::to_string(this->Lives), 5.0f, 5.0f, 1.0f);
+        text->RenderText(stage, (this->Width - text->TextWidth(stage, 1.0f)) / 2.0f, 5.0f, 1.0f);
+        text->RenderText(score, this->Width - text->TextWidth(score, 1.0f) - 5.0f, 5.0f, 1.0f);
     }
     if (this->State == GAME_MENU)
     {
+        std::string start = "Press ENTER to start", select = "Press W or S to select level";
+        text->RenderText(start, (this->Width - text->TextWidth(start, 1.0f)) / 2.0f, this->Height / 2.0f, 1.0f);
+        text->RenderText(select, (this->Width - text->TextWidth(select, 0.75f)) / 2.0f, this->Height / 2.0f + 30.0f, 0.75f);
     }
     if (this->State == GAME_WIN)
     {
+        std::string won = "You WON!!!", retry = "Press ENTER to retry or ESC to quit";
+        text->RenderText(won, (this->Width - text->TextWidth(won, 1.0f)) / 2.0f, this->Height / 2.0f - 30.0f, 1.0f, glm::vec3(0.0f, 1.0f, 0.0f));
+        text->RenderText(retry, (this->Width - text->TextWidth(retry, 1.0f)) / 2.0f, this->Height / 2.0f, 1.0f, glm::vec3(1.0f, 1.0f, 0.0f));
     }
+    // the overlay shows the counters of the last complete frame
+    if (perf->Visible)
+        perf->Draw(*renderer, *text);
+    renderer->EndFrame();
+    // all of the frame's text in one draw call
+    text->Flush();
+    resolution->EndFrame();
+    this->RecordFrame();
+}
+
+void Game::RecordFrame() {
+    // the frame's counters are recorded even while the overlay is hidden, so its lows cover the time before it was shown
+    GameLevel &level = this->Levels[this->Level];
+    PerfCounters counters;
+    counters.CPUMilliseconds = resolution->LastCPUMilliseconds;
+    counters.GPUMilliseconds = resolution->LastGPUMilliseconds;
+    // the overlay's own batch is in the sprite renderer's count and its text in the text renderer's
+    counters.DrawCalls = renderer->DrawCalls + level.DrawCalls + particles->GetGenerator().DrawCalls + text->DrawCalls + effects->DrawCalls;
+    counters.Blits = effects->Blits;
+    counters.StateChanges = GLState::Issued;
+    counters.SkippedChanges = GLState::Skipped;
+    counters.QueueStateChanges = queue->StateChanges;
+    counters.Particles = particles->Count();
+    counters.ParticleCapacity = particles->GetGenerator().Capacity();
+    counters.Bricks = level.BricksLeft();
+    counters.BricksTotal = level.BrickCount();
+    counters.PowerUps = 0;
+    for (const PowerUp &powerUp : this->PowerUps)
+        if (powerUp.Activated)
+            counters.PowerUps++;
+    counters.TextureBytes = ResourceManager::TextureMemory() + text->Atlas.Width * text->Atlas.Height
+        + effects->TextureBytes() + background->TextureBytes();
+    counters.Scale = effects->Scale;
+    counters.Samples = effects->Samples;
+    if (!resolution->History().empty())
+        counters.LastResolutionChange = resolution->History().back().Reason;
+    perf->Frame(counters);
 }
 
 // collision detection
 bool CheckCollision(GameObject &one, GameObject &two);
 Collision CheckCollision(Ball &one, GameObject &two);
+Collision CheckCollision(Ball &one, glm::vec2 position, glm::vec2 size);
 Direction VectorDirection(glm::vec2 closest);
 
 // calculates which direction a vector is facing (N,E,S or W)
@@ -259,9 +419,10 @@ Direction VectorDirection(glm::vec2 target) {
     };
     float max = 0.0f;
     unsigned int best_match = -1;
+    // the best match doesn't change with the target's length, so it needn't be normalized
     for (unsigned int i = 0; i < 4; i++)
     {
-        float dot_product = glm::dot(glm::normalize(target), compass[i]);
+        float dot_product = glm::dot(target, compass[i]);
         if (dot_product > max)
         {
             max = dot_product;
@@ -304,12 +465,17 @@ bool CheckCollision(GameObject &one, GameObject &two) // AABB - AABB collision
 }
 
 Collision CheckCollision(Ball &one, GameObject &two) // AABB - Circle collision
+{
+    return CheckCollision(one, two.Position, two.Size);
+}
+
+Collision CheckCollision(Ball &one, glm::vec2 position, glm::vec2 size) // AABB - Circle collision
 {
     // get center point circle first 
     glm::vec2 center(one.Position + one.Radius);
     // calculate AABB info (center, half-extents)
-    glm::vec2 aabb_half_extents(two.Size.x / 2.0f, two.Size.y / 2.0f);
-    glm::vec2 aabb_center(two.Position.x + aabb_half_extents.x, two.Position.y + aabb_half_extents.y);
+    glm::vec2 aabb_half_extents(size.x / 2.0f, size.y / 2.0f);
+    glm::vec2 aabb_center(position.x + aabb_half_extents.x, position.y + aabb_half_extents.y);
     // get difference vector between both centers
     glm::vec2 difference = center - aabb_center;
     glm::vec2 clamped = glm::clamp(difference, -aabb_half_extents, aabb_half_extents);
@@ -318,7 +484,7 @@ Collision CheckCollision(Ball &one, GameObject &two) // AABB - Circle collision
     // now retrieve vector between center circle and closest point AABB and check if length < radius
     difference = closest - center;
 
-    if (glm::length(difference) < one.Radius) // not <= since in that case a collision also occurs when object one exactly touches object two, which they are at the end of each collision resolution stage.
+    if (glm::dot(difference, difference) < one.Radius * one.Radius) // not <= since in that case a collision also occurs when object one exactly touches object two, which they are at the end of each collision resolution stage.
         return std::make_tuple(true, VectorDirection(difference), difference);
     else
         return std::make_tuple(false, UP, glm::vec2(0.0f, 0.0f));
@@ -355,27 +521,160 @@ void ActivatePowerUp(PowerUp &powerUp){
     }
 } 
 
-void Game::DoCollisions() {
-    for (GameObject &box : this->Levels[this->Level].Bricks) {
-        if (!box.Destroyed) {
-            Collision collision = CheckCollision(*ball, box);
+// the ball's response to touching the paddle: where it hit the paddle decides the direction
+void BounceOffPaddle(glm::vec2 ballCenter) {
+    // check where it hit the board, and change velocity based on where it hit the board
+    float centerBoard = player->Position.x + player->Size.x / 2.0f;
+    float distance = ballCenter.x - centerBoard;
+    float percentage = distance / (player->Size.x / 2.0f);
+    // then move accordingly
+    float strength = 2.0f;
+    glm::vec2 oldVelocity = ball->Velocity;
+    ball->Velocity.x = INITIAL_BALL_VELOCITY.x * percentage * strength; 
+    //Ball->Velocity.y = -Ball->Velocity.y;
+    ball->Velocity = glm::normalize(ball->Velocity) * glm::length(oldVelocity); // keep speed consistent over both axes (multiply by length of old velocity, so total strength is not changed)
+    // fix sticky paddle
+    ball->Velocity.y = -1.0f * abs(ball->Velocity.y);
+
+    ball->Stuck = ball->Sticky;
+}
+
+void Game::HitBrick(unsigned int index) {
+    GameLevel &level = this->Levels[this->Level];
+    // destroy block if not solid
+    // shake it if solid
+    if (!level.IsSolid(index)){
+        glm::vec2 position = level.BrickPosition(index);
+        level.DestroyBrick(index);
+        this->Score += 10;
+        particles->Burst(position + level.BrickSize() * 0.5f, 24, level.BrickColor(index));
+        this->SpawnPowerUps(position);
+    }
+    else{
+        ShakeTime = 0.05f;
+        effects->Shake = true;
+    }
+}
+
+void Game::SweepBall(float dt) {
+    if (ball->Stuck)
+        return;
+    GameLevel &level = this->Levels[this->Level];
+    static std::vector<unsigned int> nearby;
+    glm::vec2 size = level.BrickSize();
+    float radius = ball->Radius, width = this->Width, height = this->Height;
+    // the walls are boxes around the board, open at the bottom
+    const float wall = 1000.0f;
+    const glm::vec2 walls[3][2] = {
+        { glm::vec2(-wall, -wall), glm::vec2(0.0f, height + wall) },
+        { glm::vec2(width, -wall), glm::vec2(width + wall, height + wall) },
+        { glm::vec2(-wall, -wall), glm::vec2(width + wall, 0.0f) }
+    };
+    // what the ball hit first: a brick index, the paddle or a wall
+    const int HIT_NONE = -1, HIT_PADDLE = -2, HIT_WALL = -3;
+
+    glm::vec2 center = ball->Position + radius;
+    float remaining = dt;
+    for (unsigned int bounce = 0; bounce < MAX_BALL_BOUNCES && remaining > 0.0f && !ball->Stuck; ++bounce)
+    {
+        glm::vec2 motion = ball->Velocity * remaining;
+        SweepHit hit, first;
+        first.Time = 2.0f;
+        int target = HIT_NONE;
+        // broadphase over the cells the rest of the motion covers
+        level.Query(glm::min(center, center + motion) - radius, glm::max(center, center + motion) + radius, nearby);
+        for (unsigned int i : nearby)
+        {
+            glm::vec2 position = level.BrickPosition(i);
+            if (!level.IsDestroyed(i) && SweepCircleBox(center, radius, motion, position, position + size, hit) && hit.Time < first.Time)
+            {
+                first = hit;
+                target = i;
+            }
+        }
+        if (SweepCircleBox(center, radius, motion, player->Position, player->Position + player->Size, hit) && hit.Time < first.Time)
+        {
+            first = hit;
+            target = HIT_PADDLE;
+        }
+        for (const glm::vec2 *box : walls)
+            if (SweepCircleBox(center, radius, motion, box[0], box[1], hit) && hit.Time < first.Time)
+            {
+                first = hit;
+                target = HIT_WALL;
+            }
+        if (target == HIT_NONE)
+        {
+            center += motion;
+            break;
+        }
+
+        // move up to the contact, keeping a small gap so the next sweep doesn't start touching
+        center += motion * first.Time + first.Normal * BALL_CONTACT_GAP;
+        remaining *= 1.0f - first.Time;
+        bool reflect = true;
+        if (target == HIT_PADDLE)
+            BounceOffPaddle(center);
+        else
+        {
+            if (target >= 0)
+            {
+                reflect = !(ball->PassThrough && !level.IsSolid(target));
+                this->HitBrick(target);
+            }
+            // like the discrete test, reverse the velocity along the dominant axis of the contact
+            if (reflect)
+            {
+                if (std::abs(first.Normal.x) > std::abs(first.Normal.y))
+                    ball->Velocity.x = -ball->Velocity.x;
+                else
+                    ball->Velocity.y = -ball->Velocity.y;
+            }
+        }
+        // a corner can leave the ball still heading into the surface; reflect the rest off the real normal
+        float approach = glm::dot(ball->Velocity, first.Normal);
+        if (reflect && approach < 0.0f)
+            ball->Velocity -= 2.0f * approach * first.Normal;
+    }
+    ball->Position = center - radius;
+}
+
+void Game::DoPowerUpCollisions() {
+    for (PowerUp &powerUp : this->PowerUps){
+        if (!powerUp.Destroyed)
+        {
+            if (powerUp.Position.y >= this->Height)
+                powerUp.Destroyed = true;
+            if (CheckCollision(*player, powerUp))
+            {	// collided with player, now activate powerup
+                ActivatePowerUp(powerUp);
+                particles->Burst(powerUp.Position + powerUp.Size * 0.5f, 16, powerUp.Color, 100.0f, 0.4f);
+                powerUp.Destroyed = true;
+                powerUp.Activated = true;
+            }
+        }
+    }
+}
+
+void Game::DoCollisions(glm::vec2 ballStart) {
+    GameLevel &level = this->Levels[this->Level];
+    // broadphase: only the bricks in the grid cells the ball's path covered this step are tested
+    static std::vector<unsigned int> nearby;
+    glm::vec2 diameter(ball->Radius * 2.0f);
+    level.Query(glm::min(ballStart, ball->Position), glm::max(ballStart, ball->Position) + diameter, nearby);
+    glm::vec2 size = level.BrickSize();
+    for (unsigned int i : nearby) {
+        if (!level.IsDestroyed(i)) {
+            bool solid = level.IsSolid(i);
+            Collision collision = CheckCollision(*ball, level.BrickPosition(i), size);
             if (std::get<0>(collision)) // if collision is true
             {
-                // destroy block if not solid
-                // shake it if solid
-                if (!box.IsSolid){
-                    box.Destroyed = true;
-                    this->SpawnPowerUps(box);
-                }
-                else{
-                    ShakeTime = 0.05f;
-                    effects->Shake = true;
-                }
+                this->HitBrick(i);
 
                 // collision resolution
                 Direction dir = std::get<1>(collision);
                 glm::vec2 diff_vector = std::get<2>(collision);
-                if (!(ball->PassThrough && !box.IsSolid)){
+                if (!(ball->PassThrough && !solid)){
                     if (dir == LEFT || dir == RIGHT) // horizontal collision
                     {
                         ball->Velocity.x = -ball->Velocity.x; // reverse horizontal velocity
@@ -401,43 +700,45 @@ void Game::DoCollisions() {
         }
     }
 
-    for (PowerUp &powerUp : this->PowerUps){
-        if (!powerUp.Destroyed)
-        {
-            if (powerUp.Position.y >= this->Height)
-                powerUp.Destroyed = true;
-            if (CheckCollision(*player, powerUp))
-            {	// collided with player, now activate powerup
-                ActivatePowerUp(powerUp);
-                powerUp.Destroyed = true;
-                powerUp.Activated = true;
-            }
-        }
-    }
-    
-
     // check collisions for player pad (unless stuck)
     Collision result = CheckCollision(*ball, *player);
     if (!ball->Stuck && std::get<0>(result))
-    {
-        // check where it hit the board, and change velocity based on where it hit the board
-        float centerBoard = player->Position.x + player->Size.x / 2.0f;
-        float distance = (ball->Position.x + ball->Radius) - centerBoard;
-        float percentage = distance / (player->Size.x / 2.0f);
-        // then move accordingly
-        float strength = 2.0f;
-        glm::vec2 oldVelocity = ball->Velocity;
-        ball->Velocity.x = INITIAL_BALL_VELOCITY.x * percentage * strength; 
-        //Ball->Velocity.y = -Ball->Velocity.y;
-        ball->Velocity = glm::normalize(ball->Velocity) * glm::length(oldVelocity); // keep speed consistent over both axes (multiply by length of old velocity, so total strength is not changed)
-        // fix sticky paddle
-        ball->Velocity.y = -1.0f * abs(ball->Velocity.y);
-
-        ball->Stuck = ball->Sticky;
-    }
+        BounceOffPaddle(ball->Position + ball->Radius);
     
 }  
 
+void Game::Resize(unsigned int framebufferWidth, unsigned int framebufferHeight)
+{
+    // minimized windows report 0x0, keep the old targets
+    if (framebufferWidth == 0 || framebufferHeight == 0)
+        return;
+    this->FramebufferWidth = framebufferWidth;
+    this->FramebufferHeight = framebufferHeight;
+    // before Init there is nothing to reallocate
+    if (effects == nullptr)
+        return;
+    effects->Resize(framebufferWidth, framebufferHeight);
+    text->Load("fonts/DejaVuSansMono-Bold.ttf", 24, static_cast<float>(framebufferWidth) / this->Width);
+    background->Resize(framebufferWidth, framebufferHeight);
+    backgroundLevel = -1;
+    // the projection stays in board units, only the pixel size changes
+    glm::mat4 projection = glm::ortho(0.0f, static_cast<float>(this->Width), 
+        static_cast<float>(this->Height), 0.0f, -1.0f, 1.0f);
+    frame->SetView(projection, framebufferWidth, framebufferHeight);
+    frame->Upload();
+}
+
+void Game::BuildStaticLayer()
+{
+    background->Begin();
+    renderer->Begin();
+        renderer->DrawSprite(ResourceManager::GetTexture("background"), glm::vec2(0.0f, 0.0f), glm::vec2(this->Width, this->Height), 0.0f);
+        this->Levels[this->Level].DrawStatic(*renderer);
+    renderer->End();
+    background->End();
+    backgroundLevel = this->Level;
+}
+
 void Game::ResetLevel()
 {
     if (this->Level == 0)
@@ -450,6 +751,8 @@ void Game::ResetLevel()
         this->Levels[3].Load("levels/four.lvl", this->Width, this->Height / 2);
 
     this->Lives = 3;
+    this->Score = 0;
+    backgroundLevel = -1;
 }
 
 void Game::ResetPlayer()
@@ -458,6 +761,7 @@ void Game::ResetPlayer()
     player->Size = PLAYER_SIZE;
     // set to middle
     player->Position = glm::vec2(this->Width / 2.0f - PLAYER_SIZE.x / 2.0f, this->Height - PLAYER_SIZE.y);
+    player->PrevPosition = player->Position;
     ball->Reset(player->Position + glm::vec2(PLAYER_SIZE.x / 2.0f - BALL_RADIUS, -(BALL_RADIUS * 2.0f)), INITIAL_BALL_VELOCITY);
 }
 
@@ -467,23 +771,23 @@ bool ShouldSpawn(unsigned int chance){
     return random == 0;
 }
 
-void Game::SpawnPowerUps(GameObject &block){
+void Game::SpawnPowerUps(glm::vec2 position){
     if (ShouldSpawn(75)) // 1 in 75 chance
-        this->PowerUps.push_back(PowerUp("speed", glm::vec3(0.5f, 0.5f, 1.0f), 0.0f, block.Position,ResourceManager::GetTexture("powerup_speed")));
+        this->PowerUps.push_back(PowerUp("speed", glm::vec3(0.5f, 0.5f, 1.0f), 0.0f, position,ResourceManager::GetSubTexture("powerup_speed")));
     if (ShouldSpawn(75))
-        this->PowerUps.push_back(PowerUp("sticky", glm::vec3(1.0f, 0.5f, 1.0f), 20.0f, block.Position, ResourceManager::GetTexture("powerup_sticky")));
+        this->PowerUps.push_back(PowerUp("sticky", glm::vec3(1.0f, 0.5f, 1.0f), 20.0f, position, ResourceManager::GetSubTexture("powerup_sticky")));
     if (ShouldSpawn(75))
         this->PowerUps.push_back(
-            PowerUp("pass-through", glm::vec3(0.5f, 1.0f, 0.5f), 10.0f, block.Position, ResourceManager::GetTexture("powerup_passthrough")));
+            PowerUp("pass-through", glm::vec3(0.5f, 1.0f, 0.5f), 10.0f, position, ResourceManager::GetSubTexture("powerup_passthrough")));
     if (ShouldSpawn(75))
         this->PowerUps.push_back(
-            PowerUp("pad-size-increase", glm::vec3(1.0f, 0.6f, 0.4), 0.0f, block.Position, ResourceManager::GetTexture("powerup_increase")));
+            PowerUp("pad-size-increase", glm::vec3(1.0f, 0.6f, 0.4), 0.0f, position, ResourceManager::GetSubTexture("powerup_increase")));
     if (ShouldSpawn(15)) // negative powerups should spawn more often
         this->PowerUps.push_back(
-            PowerUp("confuse", glm::vec3(1.0f, 0.3f, 0.3f), 15.0f, block.Position, ResourceManager::GetTexture("powerup_confuse")));
+            PowerUp("confuse", glm::vec3(1.0f, 0.3f, 0.3f), 15.0f, position, ResourceManager::GetSubTexture("powerup_confuse")));
     if (ShouldSpawn(15))
         this->PowerUps.push_back(
-            PowerUp("chaos", glm::vec3(0.9f, 0.25f, 0.25f), 15.0f, block.Position, ResourceManager::GetTexture("powerup_chaos")));
+            PowerUp("chaos", glm::vec3(0.9f, 0.25f, 0.25f), 15.0f, position, ResourceManager::GetSubTexture("powerup_chaos")));
 }  
 
 bool isOtherPowerUpActive(std::vector<PowerUp> &powerUps, std::string type){
@@ -1,5 +1,7 @@
 #include "resource_manager.hpp"
+#include "GLState.h"
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <fstream>
@@ -11,6 +13,7 @@
 // Instantiate static variables
 std::map<std::string, Texture2D>    ResourceManager::Textures;
 std::map<std::string, Shader>       ResourceManager::Shaders;
+std::map<std::string, SubTexture>   ResourceManager::SubTextures;
 
 
 Shader ResourceManager::LoadShader(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile, std::string name)
@@ -19,6 +22,18 @@ Shader ResourceManager::LoadShader(const char *vShaderFile, const char *fShaderF
     return Shaders[name];
 }
 
+Shader ResourceManager::LoadFeedbackShader(const char *vShaderFile, std::vector<std::string> varyings, std::string name)
+{
+    std::ifstream vertexShaderFile(vShaderFile);
+    std::stringstream vShaderStream;
+    vShaderStream << vertexShaderFile.rdbuf();
+    std::string vertexCode = vShaderStream.str();
+    if (vertexCode.empty())
+        std::cout << "ERROR::SHADER: Failed to read shader file " << vShaderFile << std::endl;
+    Shaders[name].CompileFeedback(vertexCode.c_str(), varyings);
+    return Shaders[name];
+}
+
 Shader ResourceManager::GetShader(std::string name)
 {
     return Shaders[name];
@@ -35,6 +50,102 @@ Texture2D ResourceManager::GetTexture(std::string name)
     return Textures[name];
 }
 
+Texture2D ResourceManager::PackAtlas(std::vector<std::string> members, std::string name, unsigned int padding)
+{
+    // read the members back as RGBA and sort them tallest first for shelf packing
+    struct Image { std::string name; unsigned int width, height, x, y; std::vector<unsigned char> pixels; };
+    std::vector<Image> images;
+    unsigned int area = 0, maxWidth = 0;
+    for (std::string &member : members)
+    {
+        Texture2D &texture = Textures[member];
+        Image image = { member, texture.Width, texture.Height, 0, 0, std::vector<unsigned char>(texture.Width * texture.Height * 4) };
+        texture.Bind();
+        glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.pixels.data());
+        area += (image.width + 2 * padding) * (image.height + 2 * padding);
+        maxWidth = std::max(maxWidth, image.width + 2 * padding);
+        images.push_back(image);
+    }
+    GLState::BindTexture(0);
+    std::sort(images.begin(), images.end(), [](const Image &a, const Image &b) { return a.height > b.height; });
+
+    // atlas width: smallest power of two that fits the widest image and roughly a square of the total area
+    unsigned int width = 1;
+    while (width < maxWidth || width * width < area)
+        width *= 2;
+    // place images left to right on shelves as tall as their first (tallest) image
+    unsigned int x = 0, y = 0, shelfHeight = 0;
+    for (Image &image : images)
+    {
+        unsigned int w = image.width + 2 * padding, h = image.height + 2 * padding;
+        if (x + w > width)
+        {
+            x = 0;
+            y += shelfHeight;
+            shelfHeight = 0;
+        }
+        image.x = x + padding;
+        image.y = y + padding;
+        x += w;
+        shelfHeight = std::max(shelfHeight, h);
+    }
+    unsigned int height = 1;
+    while (height < y + shelfHeight)
+        height *= 2;
+
+    // copy every image into the atlas and extrude its border into the padding so linear filtering doesn't bleed
+    Texture2D texture;
+    std::vector<unsigned char> atlas(width * height * 4, 0);
+    for (Image &image : images)
+    {
+        for (int py = -(int)padding; py < (int)(image.height + padding); ++py)
+        {
+            for (int px = -(int)padding; px < (int)(image.width + padding); ++px)
+            {
+                int sx = std::min(std::max(px, 0), (int)image.width - 1);
+                int sy = std::min(std::max(py, 0), (int)image.height - 1);
+                const unsigned char *src = &image.pixels[(sy * image.width + sx) * 4];
+                unsigned char *dst = &atlas[((image.y + py) * width + image.x + px) * 4];
+                std::copy(src, src + 4, dst);
+            }
+        }
+        SubTextures[image.name] = SubTexture(texture,
+            glm::vec2(image.x / (float)width, image.y / (float)height),
+            glm::vec2(image.width / (float)width, image.height / (float)height));
+    }
+
+    texture.Internal_Format = GL_RGBA;
+    texture.Image_Format = GL_RGBA;
+    texture.Wrap_S = GL_CLAMP_TO_EDGE;
+    texture.Wrap_T = GL_CLAMP_TO_EDGE;
+    texture.Generate(width, height, atlas.data());
+    Textures[name] = texture;
+    for (Image &image : images)
+        SubTextures[image.name].Texture = texture;
+    return texture;
+}
+
+SubTexture ResourceManager::GetSubTexture(std::string name)
+{
+    std::map<std::string, SubTexture>::iterator it = SubTextures.find(name);
+    if (it != SubTextures.end())
+        return it->second;
+    return SubTexture(Textures[name]);
+}
+
+size_t ResourceManager::TextureMemory()
+{
+    size_t bytes = 0;
+    for (auto &iter : Textures)
+    {
+        const Texture2D &texture = iter.second;
+        // drivers pad RGB to 4 bytes per texel
+        size_t texel = texture.Internal_Format == GL_RED ? 1 : 4;
+        bytes += texel * texture.Width * texture.Height;
+    }
+    return bytes;
+}
+
 void ResourceManager::Clear()
 {
     // (properly) delete all shaders	
@@ -42,7 +153,7 @@ void ResourceManager::Clear()
         glDeleteProgram(iter.second.ID);
     // (properly) delete all textures
     for (auto iter : Textures)
-        glDeleteTextures(1, &iter.second.ID);
+        GLState::DeleteTexture(iter.second.ID);
 }
 
 Shader ResourceManager::loadShaderFromFile(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile)
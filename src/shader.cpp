@@ -7,12 +7,13 @@
 ** option) any later version.
 ******************************************************************/
 #include "shader.h"
+#include "GLState.h"
 
 #include <iostream>
 
 Shader &Shader::Use()
 {
-    glUseProgram(this->ID);
+    GLState::UseProgram(this->ID);
     return *this;
 }
 
@@ -45,6 +46,7 @@ void Shader::Compile(const char* vertexSource, const char* fragmentSource, const
         glAttachShader(this->ID, gShader);
     glLinkProgram(this->ID);
     checkCompileErrors(this->ID, "PROGRAM");
+    this->cacheUniformLocations();
     // delete the shaders as they're linked into our program now and no longer necessary
     glDeleteShader(sVertex);
     glDeleteShader(sFragment);
@@ -52,59 +54,153 @@ void Shader::Compile(const char* vertexSource, const char* fragmentSource, const
         glDeleteShader(gShader);
 }
 
-void Shader::SetFloat(const char *name, float value, bool useShader)
+void Shader::CompileFeedback(const char* vertexSource, const std::vector<std::string> &varyings)
+{
+    unsigned int sVertex = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(sVertex, 1, &vertexSource, NULL);
+    glCompileShader(sVertex);
+    checkCompileErrors(sVertex, "VERTEX");
+    // no fragment stage, the program only runs with rasterization discarded
+    this->ID = glCreateProgram();
+    glAttachShader(this->ID, sVertex);
+    std::vector<const char*> names;
+    for (const std::string &varying : varyings)
+        names.push_back(varying.c_str());
+    glTransformFeedbackVaryings(this->ID, names.size(), names.data(), GL_INTERLEAVED_ATTRIBS);
+    glLinkProgram(this->ID);
+    checkCompileErrors(this->ID, "PROGRAM");
+    this->cacheUniformLocations();
+    glDeleteShader(sVertex);
+}
+
+void Shader::BindUniformBlock(const char *name, unsigned int binding)
+{
+    unsigned int index = glGetUniformBlockIndex(this->ID, name);
+    if (index != GL_INVALID_INDEX)
+        glUniformBlockBinding(this->ID, index, binding);
+}
+
+int Shader::GetUniformLocation(const char *name) const
+{
+    std::map<std::string, int>::const_iterator it = this->Uniforms.find(name);
+    return it != this->Uniforms.end() ? it->second : -1;
+}
+
+void Shader::SetFloat(int location, float value, bool useShader)
 {
     if (useShader)
         this->Use();
-    glUniform1f(glGetUniformLocation(this->ID, name), value);
+    glUniform1f(location, value);
 }
-void Shader::SetInteger(const char *name, int value, bool useShader)
+void Shader::SetInteger(int location, int value, bool useShader)
 {
     if (useShader)
         this->Use();
-    glUniform1i(glGetUniformLocation(this->ID, name), value);
+    glUniform1i(location, value);
 }
-void Shader::SetVector2f(const char *name, float x, float y, bool useShader)
+void Shader::SetVector2f(int location, float x, float y, bool useShader)
 {
     if (useShader)
         this->Use();
-    glUniform2f(glGetUniformLocation(this->ID, name), x, y);
+    glUniform2f(location, x, y);
 }
-void Shader::SetVector2f(const char *name, const glm::vec2 &value, bool useShader)
+void Shader::SetVector2f(int location, const glm::vec2 &value, bool useShader)
 {
     if (useShader)
         this->Use();
-    glUniform2f(glGetUniformLocation(this->ID, name), value.x, value.y);
+    glUniform2f(location, value.x, value.y);
 }
-void Shader::SetVector3f(const char *name, float x, float y, float z, bool useShader)
+void Shader::SetVector3f(int location, float x, float y, float z, bool useShader)
 {
     if (useShader)
         this->Use();
-    glUniform3f(glGetUniformLocation(this->ID, name), x, y, z);
+    glUniform3f(location, x, y, z);
 }
-void Shader::SetVector3f(const char *name, const glm::vec3 &value, bool useShader)
+void Shader::SetVector3f(int location, const glm::vec3 &value, bool useShader)
 {
     if (useShader)
         this->Use();
-    glUniform3f(glGetUniformLocation(this->ID, name), value.x, value.y, value.z);
+    glUniform3f(location, value.x, value.y, value.z);
 }
-void Shader::SetVector4f(const char *name, float x, float y, float z, float w, bool useShader)
+void Shader::SetVector4f(int location, float x, float y, float z, float w, bool useShader)
 {
     if (useShader)
         this->Use();
-    glUniform4f(glGetUniformLocation(this->ID, name), x, y, z, w);
+    glUniform4f(location, x, y, z, w);
 }
-void Shader::SetVector4f(const char *name, const glm::vec4 &value, bool useShader)
+void Shader::SetVector4f(int location, const glm::vec4 &value, bool useShader)
 {
     if (useShader)
         this->Use();
-    glUniform4f(glGetUniformLocation(this->ID, name), value.x, value.y, value.z, value.w);
+    glUniform4f(location, value.x, value.y, value.z, value.w);
 }
-void Shader::SetMatrix4(const char *name, const glm::mat4 &matrix, bool useShader)
+void Shader::SetMatrix4(int location, const glm::mat4 &matrix, bool useShader)
 {
     if (useShader)
         this->Use();
-    glUniformMatrix4fv(glGetUniformLocation(this->ID, name), 1, false, glm::value_ptr(matrix));
+    glUniformMatrix4fv(location, 1, false, glm::value_ptr(matrix));
+}
+
+void Shader::SetFloat(const char *name, float value, bool useShader)
+{
+    this->SetFloat(this->GetUniformLocation(name), value, useShader);
+}
+void Shader::SetInteger(const char *name, int value, bool useShader)
+{
+    this->SetInteger(this->GetUniformLocation(name), value, useShader);
+}
+void Shader::SetVector2f(const char *name, float x, float y, bool useShader)
+{
+    this->SetVector2f(this->GetUniformLocation(name), x, y, useShader);
+}
+void Shader::SetVector2f(const char *name, const glm::vec2 &value, bool useShader)
+{
+    this->SetVector2f(this->GetUniformLocation(name), value, useShader);
+}
+void Shader::SetVector3f(const char *name, float x, float y, float z, bool useShader)
+{
+    this->SetVector3f(this->GetUniformLocation(name), x, y, z, useShader);
+}
+void Shader::SetVector3f(const char *name, const glm::vec3 &value, bool useShader)
+{
+    this->SetVector3f(this->GetUniformLocation(name), value, useShader);
+}
+void Shader::SetVector4f(const char *name, float x, float y, float z, float w, bool useShader)
+{
+    this->SetVector4f(this->GetUniformLocation(name), x, y, z, w, useShader);
+}
+void Shader::SetVector4f(const char *name, const glm::vec4 &value, bool useShader)
+{
+    this->SetVector4f(this->GetUniformLocation(name), value, useShader);
+}
+void Shader::SetMatrix4(const char *name, const glm::mat4 &matrix, bool useShader)
+{
+    this->SetMatrix4(this->GetUniformLocation(name), matrix, useShader);
+}
+
+void Shader::cacheUniformLocations()
+{
+    this->Uniforms.clear();
+    int count = 0, maxLength = 0;
+    glGetProgramiv(this->ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(this->ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    std::string name(maxLength, '\0');
+    for (int i = 0; i < count; ++i)
+    {
+        int length = 0, size = 0;
+        unsigned int type;
+        glGetActiveUniform(this->ID, i, maxLength, &length, &size, &type, &name[0]);
+        std::string uniform = name.substr(0, length);
+        int location = glGetUniformLocation(this->ID, uniform.c_str());
+        // uniforms in a uniform block have no location
+        if (location < 0)
+            continue;
+        this->Uniforms[uniform] = location;
+        // arrays are reported as "name[0]"; also make them reachable by their plain name
+        std::string::size_type bracket = uniform.find('[');
+        if (bracket != std::string::npos)
+            this->Uniforms[uniform.substr(0, bracket)] = location;
+    }
 }
 
 
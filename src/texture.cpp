@@ -9,6 +9,7 @@
 #include <iostream>
 
 #include "texture.h"
+#include "GLState.h"
 
 
 Texture2D::Texture2D()
@@ -22,7 +23,7 @@ void Texture2D::Generate(unsigned int width, unsigned int height, unsigned char*
     this->Width = width;
     this->Height = height;
     // create Texture
-    glBindTexture(GL_TEXTURE_2D, this->ID);
+    GLState::BindTexture(this->ID);
     glTexImage2D(GL_TEXTURE_2D, 0, this->Internal_Format, width, height, 0, this->Image_Format, GL_UNSIGNED_BYTE, data);
     // set Texture wrap and filter modes
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, this->Wrap_S);
@@ -30,10 +31,20 @@ void Texture2D::Generate(unsigned int width, unsigned int height, unsigned char*
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, this->Filter_Min);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, this->Filter_Max);
     // unbind texture
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLState::BindTexture(0);
 }
 
 void Texture2D::Bind() const
 {
-    glBindTexture(GL_TEXTURE_2D, this->ID);
-}
\ No newline at end of file
+    GLState::BindTexture(this->ID);
+}
+
+SubTexture::SubTexture()
+    : Texture(), UVOrigin(0.0f), UVSize(1.0f)
+{
+}
+
+SubTexture::SubTexture(const Texture2D &texture, glm::vec2 uvOrigin, glm::vec2 uvSize)
+    : Texture(texture), UVOrigin(uvOrigin), UVSize(uvSize)
+{
+}
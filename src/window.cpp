@@ -3,7 +3,10 @@
 
 #include "game.h"
 #include "resource_manager.hpp"
+#include "GLState.h"
 
+#include <cmath>
+#include <cstdlib>
 #include <iostream>
 
 // GLFW function declarations
@@ -15,6 +18,11 @@ const unsigned int SCREEN_WIDTH = 800;
 // The height of the screen
 const unsigned int SCREEN_HEIGHT = 600;
 
+// Simulation ticks per second (BREAKOUT_TICK_RATE overrides it)
+const double DEFAULT_TICK_RATE = 60.0;
+// Most ticks run in one frame; after a longer hitch the game slows down instead of spiraling
+const unsigned int MAX_CATCH_UP_TICKS = 8;
+
 Game Breakout(SCREEN_WIDTH, SCREEN_HEIGHT);
 
 int main(int argc, char *argv[])
@@ -46,45 +54,67 @@ int main(int argc, char *argv[])
     // prob: https://stackoverflow.com/questions/31303291/opengl-rendering-constricted-to-bottom-left-quarter-of-the-screen
     int framewidth, frameheight;
     glfwGetFramebufferSize(window, &framewidth, &frameheight);
+    // render targets are sized from the framebuffer
+    Breakout.Resize(framewidth, frameheight);
 
     // OpenGL configuration
     // --------------------
     // glViewport(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
     glViewport(0, 0, framewidth, frameheight);
     glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     // initialize game
     // ---------------
     Breakout.Init();
 
-    // deltaTime variables
+    // fixed timestep variables; time stays in double so it keeps its precision in long sessions
     // -------------------
-    float deltaTime = 0.0f;
-    float lastFrame = 0.0f;
+    double tickRate = DEFAULT_TICK_RATE;
+    const char *rate = std::getenv("BREAKOUT_TICK_RATE");
+    if (rate != nullptr && std::atof(rate) > 0.0)
+        tickRate = std::atof(rate);
+    const double tick = 1.0 / tickRate;
+    double accumulator = 0.0;
+    double lastFrame = glfwGetTime();
 
     while (!glfwWindowShouldClose(window))
     {
         // calculate delta time
         // --------------------
-        float currentFrame = glfwGetTime();
-        deltaTime = currentFrame - lastFrame;
+        double currentFrame = glfwGetTime();
+        accumulator += currentFrame - lastFrame;
         lastFrame = currentFrame;
         glfwPollEvents();
 
-        // manage user input
-        // -----------------
-        Breakout.ProcessInput(deltaTime);
-
-        // update game state
-        // -----------------
-        Breakout.Update(deltaTime);
+        // advance the simulation in whole ticks
+        // --------------------
+        unsigned int ticks = 0;
+        while (accumulator >= tick && ticks < MAX_CATCH_UP_TICKS)
+        {
+            Breakout.SavePositions();
+
+            // manage user input
+            // -----------------
+            Breakout.ProcessInput(static_cast<float>(tick));
+
+            // update game state
+            // -----------------
+            Breakout.Update(static_cast<float>(tick));
+
+            accumulator -= tick;
+            ticks++;
+        }
+        // time that couldn't be caught up is dropped
+        if (accumulator >= tick)
+            accumulator = std::fmod(accumulator, tick);
 
         // render
         // ------
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
-        Breakout.Render();
+        // draw between the last two ticks
+        Breakout.Render(static_cast<float>(accumulator / tick));
 
         glfwSwapBuffers(window);
     }
@@ -107,7 +137,10 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
         if (action == GLFW_PRESS)
             Breakout.Keys[key] = true;
         else if (action == GLFW_RELEASE)
+        {
             Breakout.Keys[key] = false;
+            Breakout.KeysProcessed[key] = false;
+        }
     }
 }
 
@@ -116,4 +149,6 @@ void framebuffer_size_callback(GLFWwindow* window, int width, int height)
     // make sure the viewport matches the new window dimensions; note that width and 
     // height will be significantly larger than specified on retina displays.
     glViewport(0, 0, width, height);
+    // and reallocate the render targets to the new pixel size
+    Breakout.Resize(width, height);
 }
\ No newline at end of file